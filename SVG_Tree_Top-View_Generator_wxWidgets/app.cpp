@@ -6,6 +6,11 @@ bool App::OnInit()
         return false;
     }
 
+    // Optional custom leafs
+    if (std::filesystem::exists("Resources/leafs.txt")) {
+        Tree::LeafTemplate::Load("Resources/leafs.txt");
+    }
+
     AppFrame *frame = new AppFrame("wxWidgtes App to Draw Trees", wxSize(1024, 700));
     frame->Show();
 
@@ -22,16 +27,20 @@ AppFrame::AppFrame(const wxString &title, const wxSize &size)
     submenu1->Append(ID_Menu_SaveTxt, "&TXT", "Save TXT file using custom library.");
     submenu1->AppendSeparator();
     submenu1->Append(ID_Menu_SaveHsvg, "&SVG\tCtrl-S", "Save SVG file using custom library.");
+    submenu1->Append(ID_Menu_SaveSymbols, "SVG [&symbols]", "Save SVG file with each leaf shape once, smaller.");
     submenu1->Append(ID_Menu_SaveDCsvg, "&SVG [wxWidgets]\tCtrl-Shift-S", "Save SVG file using wxWidgets library.");
+    submenu1->AppendSeparator();
+    submenu1->Append(ID_Menu_SaveProject, "&Project", "Save the branches to be opened again.");
 
     menu[0] = new wxMenu;
+    menu[0]->Append(ID_Menu_Open, "&Open Project\tCtrl-O", "Open a saved project.");
     menu[0]->AppendSubMenu(submenu1, "Save As");
     menu[0]->AppendSeparator();
     menu[0]->Append(wxID_EXIT);
 
     menu[1] = new wxMenu;
-    menu[1]->Append(ID_Menu_Undo, "&Undo\tCtrl-Z", "Remove the last branch.");
-    menu[1]->Append(ID_Menu_Redo, "&Redo\tCtrl-Y", "Reconstruct removed branch.");
+    menu[1]->Append(ID_Menu_Undo, "&Undo\tCtrl-Z", "Undo the last edit: stroke, slider, shape or colour.");
+    menu[1]->Append(ID_Menu_Redo, "&Redo\tCtrl-Y", "Redo the last undone edit.");
     menu[1]->AppendSeparator();
     menu[1]->Append(ID_Menu_Reset, "&Reset\tDelete", "Clear drawing area.");
 
@@ -47,16 +56,25 @@ AppFrame::AppFrame(const wxString &title, const wxSize &size)
     }
     submenu2->Append(ID_Array_Menu_Size + daSize.size(), "Custom\tCtrl-N");
     submenu2->Bind(wxEVT_MENU, [ = ](wxCommandEvent & event) {
-            if (!drawingArea->Resize(NewDialog(drawingArea->GetSize()).GetSize())) {
+            if (!drawingArea->Resize(NewDialog(wxSize(DrawingArea::MaxCanvas, DrawingArea::MaxCanvas)).GetSize())) {
                 SetStatusText("Invalid size!");
             }
         }, ID_Array_Menu_Size + daSize.size());
 
     menu[2] = new wxMenu;
     menu[2]->AppendSubMenu(submenu2, "New");
+    menu[2]->AppendCheckItem(ID_Menu_Detail, "Level of &Detail", "Draw small leafs simpler while painting is slow.");
+    menu[2]->Check(ID_Menu_Detail, true);
+    menu[2]->AppendSeparator();
+    menu[2]->Append(ID_Menu_ZoomIn, "Zoom &In\tCtrl-+", "Zoom in, or turn the mouse wheel.");
+    menu[2]->Append(ID_Menu_ZoomOut, "Zoom &Out\tCtrl--", "Zoom out, or turn the mouse wheel.");
+    menu[2]->Append(ID_Menu_ZoomFit, "&Fit\tCtrl-0", "Show the whole drawing area, drag the middle button to pan.");
 
     menu[3] = new wxMenu;
     menu[3]->Append(wxID_ABOUT, "&About\tF1", "Show about dialog.");
+    menu[3]->AppendSeparator();
+    menu[3]->AppendCheckItem(ID_Menu_Profile, "&Profile\tF2", "Show the time of each phase in the status bar.");
+    menu[3]->AppendCheckItem(ID_Menu_Trace, "Record &Trace\tShift-F2", "Save the timed phases as a Chrome trace.");
 
     menuBar = new wxMenuBar;
     menuBar->Append(menu[0], "&File");
@@ -68,11 +86,20 @@ AppFrame::AppFrame(const wxString &title, const wxSize &size)
     Bind(wxEVT_MENU, &AppFrame::OnSave, this, ID_Menu_SaveDCsvg);
     Bind(wxEVT_MENU, &AppFrame::OnSave, this, ID_Menu_SaveHsvg);
     Bind(wxEVT_MENU, &AppFrame::OnSave, this, ID_Menu_SaveTxt);
+    Bind(wxEVT_MENU, &AppFrame::OnSave, this, ID_Menu_SaveProject);
+    Bind(wxEVT_MENU, &AppFrame::OnSave, this, ID_Menu_SaveSymbols);
+    Bind(wxEVT_MENU, &AppFrame::OnOpen, this, ID_Menu_Open);
+    Bind(wxEVT_MENU, &AppFrame::OnProfile, this, ID_Menu_Profile);
+    Bind(wxEVT_MENU, &AppFrame::OnProfile, this, ID_Menu_Trace);
     Bind(wxEVT_MENU, [ = ](wxCommandEvent &) { AboutDialog(); }, wxID_ABOUT);
     Bind(wxEVT_MENU, [ = ](wxCommandEvent &) { Close(true); }, wxID_EXIT);
     Bind(wxEVT_MENU, [ = ](wxCommandEvent &) { Reset(); }, ID_Menu_Reset);
+    Bind(wxEVT_MENU, [ = ](wxCommandEvent & event) { drawingArea->SetDetail(event.IsChecked()); }, ID_Menu_Detail);
     Bind(wxEVT_MENU, [ = ](wxCommandEvent &) { drawingArea->OnRedo(); }, ID_Menu_Redo);
     Bind(wxEVT_MENU, [ = ](wxCommandEvent &) { drawingArea->OnUndo(); }, ID_Menu_Undo);
+    Bind(wxEVT_MENU, [ = ](wxCommandEvent &) { drawingArea->Zoom(1.25); }, ID_Menu_ZoomIn);
+    Bind(wxEVT_MENU, [ = ](wxCommandEvent &) { drawingArea->Zoom(0.8); }, ID_Menu_ZoomOut);
+    Bind(wxEVT_MENU, [ = ](wxCommandEvent &) { drawingArea->ZoomFit(); }, ID_Menu_ZoomFit);
 
     // Font
     wxFont font(14, wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
@@ -99,10 +126,10 @@ AppFrame::AppFrame(const wxString &title, const wxSize &size)
         txtCtrl[i]->Show(false);
     }
 
-    labels = {"Angle", "Lenght", "Distance", "Width"};
+    labels = {"Angle", "Lenght", "Distance", "Width", "Smooth"};
     tips = {"Angle of the leaf on the branch of the tree", "Tree leaf length.",
-            "Distance between tree leaves.", "Branch thickness."};
-    for (unsigned i = 0; i < 4; i++) {
+            "Distance between tree leaves.", "Branch thickness.", "Mouse points closer than this to the stroke are dropped."};
+    for (unsigned i = 0; i < 5; i++) {
         label[i] = new wxStaticText(this, ID_Array_Label_Info + i, labels[i]);
         label[i]->SetToolTip(tips[i]);
         label[i]->SetFont(font1);
@@ -118,10 +145,11 @@ AppFrame::AppFrame(const wxString &title, const wxSize &size)
     slider[1] = new wxSlider(this, ID_Array_Slider + 1, 50, 0, 150);   // shapeLenght
     slider[2] = new wxSlider(this, ID_Array_Slider + 2, 10, 0,  50);   // limitLength
     slider[3] = new wxSlider(this, ID_Array_Slider + 3, 2,  0,  20);   // lineTickness
+    slider[4] = new wxSlider(this, ID_Array_Slider + 4, 1,  0,  10);   // simplification tolerance
 
     tips = {"Angle of the leaf on the branch.", "Leaf lenght.", "Minimum distance between sheets.",
-            "Branch thickness."};
-    for (unsigned i = 0; i < 4; ++i) {
+            "Branch thickness.", "Simplification of the next strokes in pixels, 0 keeps every point."};
+    for (unsigned i = 0; i < 5; ++i) {
         slider[i]->SetToolTip(tips[i]);
     }
 
@@ -145,6 +173,11 @@ AppFrame::AppFrame(const wxString &title, const wxSize &size)
         slider[3]->SetToolTip(std::to_string(drawingArea->GetValue(3)));
     });
 
+    slider[4]->Bind(wxEVT_SLIDER, [ = ](wxCommandEvent & event) {
+        drawingArea->SetValue(4, slider[4]->GetValue());
+        slider[4]->SetToolTip(std::to_string(drawingArea->GetValue(4)));
+    });
+
     // Check Box
     checkBox[0] = new wxCheckBox(this, ID_ChkBox_Spline, "SpLine");
     checkBox[0]->SetToolTip("Draw in Spline or Polygon.");
@@ -281,7 +314,9 @@ AppFrame::AppFrame(const wxString &title, const wxSize &size)
     hBox[3]->Add(slider[2], 0, wxRIGHT, 4);
     hBox[3]->Add(colorPCtrl[2], 0, wxRIGHT, 5);     // Branch color
     hBox[3]->Add(label[3]);                         // Line Tickness - Branch
-    hBox[3]->Add(slider[3]);
+    hBox[3]->Add(slider[3], 0, wxRIGHT, 4);
+    hBox[3]->Add(label[4], 0, wxRIGHT, 4);          // Stroke simplification
+    hBox[3]->Add(slider[4]);
 
     vBox[0]->AddSpacer(10);
     vBox[0]->Add(hBox[0], 1, wxEXPAND);             // Info
@@ -306,8 +341,8 @@ AppFrame::AppFrame(const wxString &title, const wxSize &size)
     drawingArea->Bind(wxEVT_LEFT_DOWN, [ = ](wxMouseEvent & event) {
         drawingArea->OnMouseClicked(event);
         SetStatusText("");
-        info[0]->SetLabelText("Area: " + std::to_string(drawingArea->GetSize().GetWidth())
-                              + " x " + std::to_string(drawingArea->GetSize().GetHeight()));
+        info[0]->SetLabelText("Area: " + std::to_string(drawingArea->GetCanvasSize().GetWidth())
+                              + " x " + std::to_string(drawingArea->GetCanvasSize().GetHeight()));
     });
 
     Bind(wxEVT_CHAR_HOOK, &AppFrame::OnKeyDown, this);
@@ -324,11 +359,15 @@ void AppFrame::OnSave(wxCommandEvent &event)
     switch (event.GetId()) {
     case ID_Menu_SaveDCsvg:
     case ID_Menu_SaveHsvg:
+    case ID_Menu_SaveSymbols:
         filter = "SVG vector picture (*.svg)|*.svg";
         break;
     case ID_Menu_SaveTxt:
         filter = "Text file (*.txt)|*.txt" ;
         break;
+    case ID_Menu_SaveProject:
+        filter = "Project (*.svgtree)|*.svgtree";
+        break;
     default:
         filter = "All files | *.*";
         break;
@@ -343,14 +382,19 @@ void AppFrame::OnSave(wxCommandEvent &event)
             result = drawingArea->OnSaveSvgDC(path);
             break;
         case ID_Menu_SaveHsvg:
+        case ID_Menu_SaveSymbols:
             result = drawingArea->OnSaveSvg(path, SVG::Metadata(
                                                       std::string(txtCtrl[0]->GetValue()),
                                                       std::string(txtCtrl[1]->GetValue()),
-                                                      std::string(txtCtrl[2]->GetValue())));
+                                                      std::string(txtCtrl[2]->GetValue())),
+                                            event.GetId() == ID_Menu_SaveSymbols);
             break;
         case ID_Menu_SaveTxt:
             result = drawingArea->OnSaveTxT(path);
             break;
+        case ID_Menu_SaveProject:
+            result = drawingArea->OnSaveProject(path);
+            break;
         default:
             break;
         }
@@ -364,6 +408,51 @@ void AppFrame::OnSave(wxCommandEvent &event)
     }
 }
 
+void AppFrame::OnOpen(wxCommandEvent &event)
+{
+    wxFileDialog dialog(this, "Open Project", wxEmptyString, wxEmptyString, "Project (*.svgtree)|*.svgtree",
+                        wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+    if (dialog.ShowModal() == wxID_OK) {
+        auto path = dialog.GetPath();
+        if (drawingArea->OnOpenProject(path)) {
+            wxString filename = std::filesystem::path(std::string(path)).filename().string();
+            SetStatusText("Open: " + filename);
+        }
+        else {
+            SetStatusText("There was something wrong!");
+        }
+    }
+}
+
+void AppFrame::OnProfile(wxCommandEvent &event)
+{
+    // The summary goes in a second field while profiling
+    auto isEnabled = menuBar->IsChecked(ID_Menu_Profile) || menuBar->IsChecked(ID_Menu_Trace);
+    if (isEnabled && !Tree::Profiler::Enabled()) {
+        Tree::Profiler::Reset();
+    }
+
+    if (event.GetId() == ID_Menu_Trace && event.IsChecked()) {
+        Tree::Profiler::StartTrace();
+    }
+    else if (event.GetId() == ID_Menu_Trace) {
+        // Events kept since it was checked, dropped if no file is chosen
+        wxFileDialog dialog(this, "Save Trace as", wxEmptyString, "trace", "Chrome trace (*.json)|*.json",
+                            wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+        auto path = dialog.ShowModal() == wxID_OK ? std::string(dialog.GetPath()) : std::string();
+        auto result = Tree::Profiler::StopTrace(path);
+        if (!path.empty()) {
+            wxString filename = std::filesystem::path(path).filename().string();
+            SetStatusText(result ? "Save: " + filename : "There was something wrong!");
+        }
+    }
+    Tree::Profiler::Enable(isEnabled);
+    statusBar->SetFieldsCount(isEnabled ? 2 : 1);
+    if (isEnabled) {
+        SetStatusText(Tree::Profiler::Summary(), 1);
+    }
+}
+
 void AppFrame::OnKeyDown(wxKeyEvent &event)
 {
     auto keyCode = event.GetKeyCode();
@@ -380,7 +469,7 @@ void AppFrame::OnKeyDown(wxKeyEvent &event)
     }
     if (keyCode == 82) {     // R
         if (checkBox[1]->GetValue()) {
-            drawingArea->SetShape(currentShape);
+            drawingArea->Reseed();
         }
     }
     if (keyCode == 127) {   // Delete
@@ -46,14 +46,23 @@ private:
         ID_ChkBox_Length,
         ID_ChkBox_Distance,
         ID_DrawingArea,
+        ID_Menu_Detail,
         ID_Menu_New,
+        ID_Menu_Open,
+        ID_Menu_Profile,
         ID_Menu_Redo,
         ID_Menu_Reset,
         ID_Menu_Save,
         ID_Menu_SaveDCsvg,
         ID_Menu_SaveHsvg,
+        ID_Menu_SaveProject,
+        ID_Menu_SaveSymbols,
         ID_Menu_SaveTxt,
+        ID_Menu_Trace,
         ID_Menu_Undo,
+        ID_Menu_ZoomFit,
+        ID_Menu_ZoomIn,
+        ID_Menu_ZoomOut,
         ID_StatuBar,
         // Arrays
         ID_Array_BitmapButton = 100,
@@ -76,13 +85,15 @@ private:
     wxColourPickerCtrl *colorPCtrl[3];
     wxMenu             *menu[4];
     wxMenuBar          *menuBar;
-    wxSlider           *slider[4];
+    wxSlider           *slider[5];
     wxStaticText       *info[4];
-    wxStaticText       *label[4];
+    wxStaticText       *label[5];
     wxStatusBar        *statusBar;
     wxTextCtrl         *txtCtrl[3];
 
     void OnKeyDown(wxKeyEvent &event);
+    void OnOpen(wxCommandEvent &event);
+    void OnProfile(wxCommandEvent &event);
     void OnSave(wxCommandEvent &event);
     void Reset();
 
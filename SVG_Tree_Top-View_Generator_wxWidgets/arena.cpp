@@ -0,0 +1,93 @@
+#include "arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Tree {
+
+Arena::Arena(std::size_t capacity, std::pmr::memory_resource *upstream)
+    : upstream(upstream), buffer(capacity > 0 ? new std::byte[capacity] : nullptr), capacity(capacity)
+{
+}
+
+Arena::~Arena()
+{
+    Release();
+}
+
+void Arena::Release()
+{
+    for (auto &block : blocks) {
+        upstream->deallocate(block.data, block.bytes, block.alignment);
+    }
+    blocks.clear();
+}
+
+auto Arena::Used() const -> std::size_t
+{
+    return std::min(offset.load(std::memory_order_relaxed), capacity) + overflow.load(std::memory_order_relaxed);
+}
+
+void Arena::Reset()
+{
+    // Room for the last use in one buffer, with some margin
+    auto peak = Used();
+    Release();
+    if (peak > capacity) {
+        capacity = peak + peak / 4;
+        buffer.reset(new std::byte[capacity]);
+    }
+    offset.store(0, std::memory_order_relaxed);
+    overflow.store(0, std::memory_order_relaxed);
+}
+
+auto Arena::do_allocate(std::size_t bytes, std::size_t alignment) -> void *
+{
+    // Only distinct ranges are needed, the memory is published by whoever hands the pointer over
+    auto base = reinterpret_cast<std::uintptr_t>(buffer.get());
+    auto current = offset.load(std::memory_order_relaxed);
+    while (current <= capacity) {
+        auto start = ((base + current + alignment - 1) & ~(alignment - 1)) - base;
+        if (start + bytes > capacity) {
+            break;
+        }
+        if (offset.compare_exchange_weak(current, start + bytes, std::memory_order_relaxed)) {
+            return buffer.get() + start;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto *data = upstream->allocate(bytes, alignment);
+    blocks.push_back({data, bytes, alignment});
+    overflow.fetch_add(bytes, std::memory_order_relaxed);
+
+    return data;
+}
+
+auto ArenaPool::Get() -> std::shared_ptr<Arena>
+{
+    std::unique_ptr<Arena> arena;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->arenas.empty()) {
+            arena = std::move(state->arenas.back());
+            state->arenas.pop_back();
+        }
+    }
+    if (arena) {
+        arena->Reset();     // its last user is done, see the deleter
+    }
+    else {
+        arena = std::make_unique<Arena>();
+    }
+
+    return std::shared_ptr<Arena>(arena.release(), [state = state](Arena *arena) {
+        std::unique_ptr<Arena> owner(arena);
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->arenas.size() < MaxIdle) {
+            state->arenas.push_back(std::move(owner));
+        }
+    });
+}
+
+} // namespace Tree
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+/*
+ * Monotonic memory of the geometry of one rebuild.
+ *
+ * Allocations move a pointer in one buffer, from any thread, and are never freed one by one:
+ * Reset() frees all of them at once. Past the end of the buffer the upstream resource is used, and the buffer
+ * grows to the peak at the next Reset(), so after a rebuild or two the geometry costs no allocation at all.
+ */
+namespace Tree {
+
+class Arena : public std::pmr::memory_resource {
+public:
+    explicit Arena(std::size_t capacity = 0, std::pmr::memory_resource *upstream = std::pmr::new_delete_resource());
+    ~Arena() override;
+
+    Arena(const Arena &) = delete;
+    auto operator=(const Arena &) -> Arena & = delete;
+
+    // Nothing allocated may be in use.
+    void Reset();
+
+    // Bytes handed out since the last Reset(), in the buffer and upstream.
+    [[nodiscard]] auto Used() const -> std::size_t;
+    [[nodiscard]] auto Capacity() const -> std::size_t { return capacity; }
+
+protected:
+    auto do_allocate(std::size_t bytes, std::size_t alignment) -> void * override;
+    void do_deallocate(void *, std::size_t, std::size_t) override {}
+    [[nodiscard]] auto do_is_equal(const std::pmr::memory_resource &other) const noexcept -> bool override
+    {
+        return this == &other;
+    }
+
+private:
+    struct Block {
+        void *data;
+        std::size_t bytes;
+        std::size_t alignment;
+    };
+
+    std::pmr::memory_resource *upstream;
+    std::unique_ptr<std::byte[]> buffer;
+    std::size_t capacity = 0;
+    std::atomic<std::size_t> offset = 0;
+
+    std::mutex mutex;           // past the buffer
+    std::vector<Block> blocks;
+    std::atomic<std::size_t> overflow = 0;
+
+    void Release();
+};
+
+/*
+ * Arenas handed out empty and taken back when their last copy is dropped.
+ *
+ * Copies of the pool share its arenas, which outlive it while in use. Past MaxIdle arenas, as after the
+ * checkpoints of the undo history are dropped, the ones taken back are freed.
+ */
+class ArenaPool {
+public:
+    static constexpr std::size_t MaxIdle = 2;
+
+    auto Get() -> std::shared_ptr<Arena>;
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Arena>> arenas;
+    };
+
+    std::shared_ptr<State> state = std::make_shared<State>();
+};
+
+} // namespace Tree
@@ -0,0 +1,625 @@
+/*
+ * Benchmarks of the geometry and export hot paths.
+ *
+ * Usage:
+ *
+ *      SVG_TreeBenchmark [maximum number of leafs]
+ *
+ * Synthetic drawings from 1k leafs up to the maximum (default 1M) are generated and exported.
+ * Each line reports the time and the allocations per operation and the bytes written.
+ *
+ */
+
+#include "tree.h"
+#include "arena.h"
+#include "detail.h"
+#include "exporter.h"
+#include "history.h"
+#include "leafKernel.h"
+#include "profiler.h"
+#include "project.h"
+#include "spatialGrid.h"
+#include "stroke.h"
+#include "threadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// Allocation counters, every allocation of the program goes through here: the whole set of replaceable
+// operators is defined, so that no pointer is freed by an operator of another family.
+static std::atomic<std::size_t> allocations = 0;
+static std::atomic<std::size_t> allocatedBytes = 0;
+
+static auto Allocate(std::size_t size, std::size_t alignment = 0) noexcept -> void *
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    size = std::max<std::size_t>(size, 1);
+    if (alignment == 0) {
+        return std::malloc(size);
+    }
+    alignment = std::max(alignment, sizeof(void *));
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+static auto AllocateOrThrow(std::size_t size, std::size_t alignment = 0) -> void *
+{
+    if (auto *pointer = Allocate(size, alignment)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size) { return AllocateOrThrow(size); }
+void *operator new[](std::size_t size) { return AllocateOrThrow(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return Allocate(size); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return Allocate(size); }
+
+// Used by the std::pmr containers.
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    return AllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return AllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return Allocate(size, static_cast<std::size_t>(alignment));
+}
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return Allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { std::free(pointer); }
+
+// Counts the bytes of a document without keeping it.
+class NullSink : public SVG::Sink {
+protected:
+    void write(const char *, std::size_t) override {}
+};
+
+// Keeps the optimizer from discarding results.
+static volatile std::size_t sink = 0;
+
+template <typename Function>
+void Measure(const std::string &name, std::size_t operations, Function function)
+{
+    auto count = allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    std::size_t bytes = function();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    count = allocations.load() - count;
+
+    operations = operations == 0 ? 1 : operations;
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << elapsed.count() / operations << " ns/op"
+              << std::setw(10) << std::setprecision(2) << static_cast<double>(count) / operations << " allocs/op"
+              << std::setw(14) << bytes << " bytes\n";
+    sink = sink + bytes;
+}
+
+// Branches with two leafs for each point, inside a square canvas.
+auto Synthetic(std::size_t leafs, int &size) -> Tree::Drawing
+{
+    constexpr unsigned pointsPerPath = 500;
+    constexpr int step = 11;    // greater than limitLength
+
+    Tree::Drawing drawing;
+    drawing.generator.randomColorShapeBrush = false;
+    size = 4000;
+    drawing.width = size;
+    drawing.height = size;
+
+    std::mt19937 random(leafs);
+    std::uniform_int_distribution<int> start(200, size - 200);
+    std::uniform_int_distribution<int> turn(-20, 20);
+    std::size_t points = leafs / 2 + 1;
+    for (unsigned number = 0; points > 1; number++) {
+        Tree::Path path(Tree::Point(start(random), start(random)), number % 11, 60, 30, 10);
+        path.points.push_back(path.points.front());
+        int angle = start(random);
+        for (unsigned i = 1; i < pointsPerPath && points > 1; i++, points--) {
+            angle += turn(random);
+            auto next = Tree::angularCoordinate(path.points.back(), step, angle);
+            next.x = std::clamp(next.x, 0, size);
+            next.y = std::clamp(next.y, 0, size);
+            path.points.push_back(next);
+        }
+        drawing.paths.push_back(path);
+    }
+
+    return drawing;
+}
+
+void Geometry()
+{
+    constexpr std::size_t count = 1000000;
+
+    std::cout << "\nGeometry: " << count << " operations\n";
+    for (unsigned shape = 0; shape < 11; shape++) {
+        Measure("GetPoints " + std::to_string(shape), count, [&]() {
+            std::size_t vertices = 0;
+            for (std::size_t i = 0; i < count; i++) {
+                vertices += Tree::Generator::GetPoints(shape, Tree::Point(100, 100), 50, i % 360).size();
+            }
+            return vertices * sizeof(Tree::Point);
+        });
+    }
+    Measure("LineAngle", count, [&]() {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < count; i++) {
+            total += LineAngle(100, 100, i % 200, (i / 200) % 200);
+        }
+        sink = sink + total;
+        return std::size_t(0);
+    });
+    Measure("Distance", count, [&]() {
+        double total = 0;
+        for (std::size_t i = 0; i < count; i++) {
+            total += Distance(100, 100, i % 200, (i / 200) % 200);
+        }
+        sink = sink + static_cast<std::size_t>(total);
+        return std::size_t(0);
+    });
+    Measure("Cos", count, [&]() {
+        double total = 0;
+        for (std::size_t i = 0; i < count; i++) {
+            total += Cos(100, 50, i % 720 - 360);
+        }
+        sink = sink + static_cast<std::size_t>(total);
+        return std::size_t(0);
+    });
+    Measure("Sin", count, [&]() {
+        double total = 0;
+        for (std::size_t i = 0; i < count; i++) {
+            total += Sin(100, 50, i % 720 - 360);
+        }
+        sink = sink + static_cast<std::size_t>(total);
+        return std::size_t(0);
+    });
+}
+
+// Leaf kernels on the same batch, small enough to stay in cache. The points must be identical.
+void Kernels(std::size_t count, std::size_t repetitions)
+{
+    std::mt19937 random(1);
+    std::uniform_int_distribution<int> coordinate(0, 4000);
+    std::uniform_int_distribution<unsigned> angle(0, 720);
+    std::uniform_int_distribution<unsigned> lenght(0, 150);
+    Tree::LeafBatch batch;
+    for (std::size_t i = 0; i < count; i++) {
+        batch.push(Tree::Point(coordinate(random), coordinate(random)), lenght(random), angle(random));
+    }
+
+    std::cout << "\nKernels: " << count << " leafs x " << repetitions << ", best " << Tree::KernelName(Tree::Kernel::Auto) << "\n";
+    for (unsigned shape : {2, 7}) {
+        auto &leaf = Tree::LeafTemplate::Get(shape);
+        std::vector<Tree::Point> expected(count * leaf.size()), points(expected.size());
+        for (std::size_t i = 0; i < count; i++) {
+            leaf.Instantiate(Tree::Point(batch.x[i], batch.y[i]), batch.lenght[i], batch.angle[i],
+                             &expected[i * leaf.size()]);
+        }
+        for (auto kernel : {Tree::Kernel::Scalar, Tree::Kernel::SSE2, Tree::Kernel::AVX2}) {
+            std::string name = std::string(Tree::KernelName(kernel)) + " shape " + std::to_string(shape);
+            Measure(name + " (per leaf)", count * repetitions, [&]() {
+                for (std::size_t i = 0; i < repetitions; i++) {
+                    Tree::InstantiateBatch(leaf, batch, points.data(), kernel);
+                }
+                return points.size() * sizeof(Tree::Point);
+            });
+            if (points != expected) {
+                std::cerr << name << ": points differ from LeafTemplate::Instantiate\n";
+            }
+        }
+    }
+}
+
+// Mouse samples of the synthetic branches: every 2 px along the segments, with 1 px of jitter.
+void Strokes(std::size_t leafs)
+{
+    int size = 0;
+    auto drawing = Synthetic(leafs, size);
+    std::mt19937 random(1);
+    std::uniform_int_distribution<int> jitter(-1, 1);
+    std::size_t samples = 0;
+    for (auto &path : drawing.paths) {
+        std::vector<Tree::Point> points = {path.points[0], path.points[1]};
+        for (std::size_t i = 2; i < path.points.size(); i++) {
+            auto a = path.points[i - 1], b = path.points[i];
+            for (int t = 1; t <= 5; t++) {
+                points.push_back(Tree::Point(a.x + (b.x - a.x) * t / 5 + (t < 5 ? jitter(random) : 0),
+                                             a.y + (b.y - a.y) * t / 5 + (t < 5 ? jitter(random) : 0)));
+            }
+        }
+        samples += points.size();
+        path.points = std::move(points);
+    }
+
+    std::cout << "\nStrokes: " << samples << " mouse samples\n";
+    auto &generator = drawing.generator;
+    std::vector<Tree::Branch> expected;
+    generator.Update(drawing.paths, expected);
+    for (double tolerance : {0.0, 1.0, 2.0}) {
+        auto paths = drawing.paths;
+        std::size_t points = 0;
+        Measure("Simplify " + std::to_string(static_cast<int>(tolerance)) + " px (per sample)", samples, [&]() {
+            for (auto &path : paths) {
+                Tree::Simplify(path, tolerance);
+                points += path.points.size();
+            }
+            return points * sizeof(Tree::Point);
+        });
+        std::vector<Tree::Branch> branches;
+        std::size_t shapes = 0;
+        Measure("  Update (per sample)", samples, [&]() {
+            shapes = generator.Update(paths, branches);
+            return std::size_t(0);
+        });
+        std::cout << "  " << points << " points, " << shapes << " shapes\n";
+        for (std::size_t i = 0; i < branches.size(); i++) {
+            auto &leafs = branches[i].leafs;
+            bool same = leafs.size() == expected[i].leafs.size();
+            for (std::size_t j = 0; same && j < leafs.size(); j++) {
+                same = std::ranges::equal(leafs.points(j), expected[i].leafs.points(j));
+            }
+            if (!same) {
+                std::cerr << "Simplified branch " << i << ": leafs differ\n";
+                break;
+            }
+        }
+        Measure("  OnSaveSvg (per sample)", samples, [&]() {
+            NullSink output;
+            SVG::Writer writer(output);
+            generator.Svg(writer, branches, size, size, SVG::Metadata());
+            return output.bytes();
+        });
+    }
+}
+
+void Coordinates(std::size_t count)
+{
+    std::vector<SVG::Point> points;
+    points.reserve(count);
+    std::mt19937 random(1);
+    std::uniform_int_distribution<int> coordinate(0, 4000);
+    for (std::size_t i = 0; i < count; i++) {
+        points.push_back(SVG::Point(coordinate(random), coordinate(random)));
+    }
+
+    std::cout << "\nCoordinates: " << count << " points\n";
+    Measure("std::to_string", count, [&]() {
+        std::size_t bytes = 0;
+        for (auto &point : points) {
+            bytes += (std::to_string(point.x) + "," + std::to_string(point.y)).size();
+        }
+        return bytes;
+    });
+
+    std::vector<std::pair<std::string, SVG::Precision>> precisions = {
+        {"format integer", SVG::Precision::Integer}, {"format 1", SVG::Precision::One},
+        {"format 2", SVG::Precision::Two}, {"format full", SVG::Precision::Full}
+    };
+    for (auto &[name, precision] : precisions) {
+        char buffer[2 * SVG::NumberSize + 1];
+        Measure(name, count, [&]() {
+            std::size_t bytes = 0;
+            for (auto &point : points) {
+                auto size = SVG::format(buffer, point.x, precision);
+                buffer[size++] = ',';
+                bytes += size + SVG::format(buffer + size, point.y, precision);
+            }
+            return bytes;
+        });
+    }
+}
+
+// Cost of a timed scope and a counter, disabled and enabled.
+void Profiling(std::size_t count)
+{
+    std::cout << "\nProfiler: " << count << " scopes\n";
+    for (auto isEnabled : {false, true}) {
+        Tree::Profiler::Enable(isEnabled);
+        Measure(isEnabled ? "Scope enabled" : "Scope disabled", count, [&]() {
+            for (std::size_t i = 0; i < count; i++) {
+                Tree::Profiler::Scope scope(Tree::Profiler::Phase::Draw);
+                Tree::Profiler::Add(Tree::Profiler::Counter::Vertices, i);
+            }
+            return std::size_t(0);
+        });
+    }
+    Tree::Profiler::Enable(false);
+    Tree::Profiler::Reset();
+}
+
+void Drawing(std::size_t leafs)
+{
+    int size = 0;
+    auto drawing = Synthetic(leafs, size);
+    auto &generator = drawing.generator;
+    std::vector<Tree::Branch> branches;
+    std::size_t shapes = 0;
+
+    std::cout << "\nDrawing: " << leafs << " leafs, " << drawing.paths.size() << " branches\n";
+    Measure("Update (per leaf)", leafs, [&]() {
+        shapes = generator.Update(drawing.paths, branches);
+        return std::size_t(0);
+    });
+    Measure("Update again (per leaf)", leafs, [&]() {
+        shapes = generator.Update(drawing.paths, branches);
+        return std::size_t(0);
+    });
+    Tree::Profiler::Enable(true);
+    Measure("Update profiled (per leaf)", leafs, [&]() {
+        shapes = generator.Update(drawing.paths, branches);
+        return std::size_t(0);
+    });
+    Tree::Profiler::Enable(false);
+    Tree::Profiler::Reset();
+    {
+        // New branches, as the background rebuilds make them
+        std::vector<Tree::Branch> rebuilt;
+        Measure("Update new (per leaf)", leafs, [&]() {
+            rebuilt = {};
+            generator.Update(drawing.paths, rebuilt);
+            return std::size_t(0);
+        });
+        Tree::ArenaPool arenas;
+        std::shared_ptr<Tree::Arena> arena;
+        auto update = [&]() {
+            rebuilt = {};
+            arena.reset();
+            arena = arenas.Get();   // the previous one, grown to fit
+            generator.Update(drawing.paths, rebuilt, arena.get());
+            return arena->Used();
+        };
+        update();
+        Measure("Update new arena (per leaf)", leafs, update);
+        rebuilt = {};
+    }
+    {
+        // Undo and redo of a global edit, with its checkpoint and with a budget too small for it
+        Tree::ArenaPool arenas;
+        auto paths = drawing.paths;
+        auto edited = generator;
+        Tree::Geometry geometry;
+        auto rebuild = [&](Tree::History & history) {
+            history.Keep(std::move(geometry));
+            geometry.arena = arenas.Get();
+            edited.Update(paths, geometry.branches, geometry.arena.get());
+        };
+        for (std::size_t budget : {std::size_t(1) << 30, std::size_t(0)}) {
+            Tree::History history(budget);
+            rebuild(history);
+            auto before = edited;
+            edited.lineWidth++;
+            history.SetGenerator(before, edited, true);
+            rebuild(history);
+            Measure(std::string("Undo ") + (budget > 0 ? "checkpoint" : "rebuild") + " (per leaf)", leafs, [&]() {
+                auto change = history.Undo(paths, edited, geometry, true);
+                if (change.kind == Tree::History::Change::Kind::All) {
+                    rebuild(history);
+                }
+                change = history.Redo(paths, edited, geometry, true);
+                if (change.kind == Tree::History::Change::Kind::All) {
+                    rebuild(history);
+                }
+                return history.Bytes();
+            });
+        }
+    }
+    Tree::ThreadPool pool;
+    std::vector<Tree::Branch> parallel;
+    Measure("Update " + std::to_string(pool.Size()) + " workers (per leaf)", leafs, [&]() {
+        generator.Update(drawing.paths, parallel, pool);
+        return std::size_t(0);
+    });
+    if (generator.Txt(parallel, size, size) != generator.Txt(branches, size, size)) {
+        std::cerr << "Parallel update differs from the serial one\n";
+    }
+    parallel = {};
+
+    std::size_t memory = 0;
+    for (auto &branch : branches) {
+        memory += branch.leafs.memory();
+    }
+    std::cout << "Shape store: " << memory / std::max<std::size_t>(leafs, 1) << " bytes/leaf\n";
+
+    // Vertices drawn for the leafs a few pixels long, against all of them
+    Measure("Detail coarse (per leaf)", leafs, [&]() {
+        std::size_t vertices = 0;
+        Tree::Point points[4];
+        for (auto &branch : branches) {
+            for (std::size_t i = 0; i < branch.leafs.size(); i++) {
+                vertices += Tree::Coarse(branch.leafs.points(i), points);
+            }
+        }
+        return vertices * sizeof(Tree::Point);
+    });
+    Measure("Detail full (per leaf)", leafs, [&]() {
+        std::size_t vertices = 0;
+        for (auto &branch : branches) {
+            for (std::size_t i = 0; i < branch.leafs.size(); i++) {
+                vertices += branch.leafs.points(i).size();
+            }
+        }
+        return vertices * sizeof(Tree::Point);
+    });
+
+    Tree::SpatialGrid grid(size, size);
+    Measure("SpatialGrid build (per leaf)", leafs, [&]() {
+        grid.build(branches);
+        return std::size_t(0);
+    });
+    constexpr std::size_t queries = 10000;
+    std::vector<Tree::SpatialGrid::Entry> found;
+    Measure("SpatialGrid query 256 px", queries, [&]() {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < queries; i++) {
+            Tree::Point corner((i * 37) % (size - 256), (i * 91) % (size - 256));
+            found.clear();
+            grid.query(Tree::Box(corner, corner + Tree::Point(256, 256)), found);
+            total += found.size();
+        }
+        return total * sizeof(Tree::SpatialGrid::Entry) / queries;
+    });
+    Measure("SpatialGrid at", queries, [&]() {
+        std::size_t hits = 0;
+        for (std::size_t i = 0; i < queries; i++) {
+            hits += grid.at(Tree::Point((i * 37) % size, (i * 91) % size), branches, generator.lineWidth) >= 0;
+        }
+        return hits;
+    });
+
+    std::vector<SVG::Shape> svgShapes;
+    for (auto &branch : branches) {
+        auto &leafs = branch.leafs;
+        for (std::size_t i = 0; i < leafs.size(); i++) {
+            SVG::Shape shape(Tree::ShapeName(leafs.kind(i)), leafs.brush(i).toHex(), leafs.pen(i).toHex(),
+                             leafs.lineWidth(i));
+            for (auto &point : leafs.points(i)) {
+                shape.points.push_back(SVG::Point(point.x, point.y));
+            }
+            svgShapes.push_back(shape);
+        }
+    }
+    Measure("SVG::polygon", svgShapes.size(), [&]() {
+        std::size_t bytes = 0;
+        for (auto &shape : svgShapes) {
+            bytes += SVG::polygon(shape).size();
+        }
+        return bytes;
+    });
+    Measure("SVG::polyline", svgShapes.size(), [&]() {
+        std::size_t bytes = 0;
+        for (auto &shape : svgShapes) {
+            bytes += SVG::polyline(shape).size();
+        }
+        return bytes;
+    });
+    svgShapes = {};
+
+    Measure("SVG::Writer polygon", leafs, [&]() {
+        NullSink output;
+        SVG::Writer writer(output);
+        for (auto &branch : branches) {
+            auto &leafs = branch.leafs;
+            for (std::size_t i = 0; i < leafs.size(); i++) {
+                writer.polygon(Tree::ShapeName(leafs.kind(i)), "#32C832", "#006600", leafs.lineWidth(i),
+                               leafs.points(i));
+            }
+        }
+        return output.bytes();
+    });
+    Measure("OnSaveSvg (per shape)", shapes, [&]() {
+        NullSink output;
+        SVG::Writer writer(output);
+        generator.Svg(writer, branches, size, size, SVG::Metadata());
+        return output.bytes();
+    });
+    Measure("OnSaveSvg symbols (per shape)", shapes, [&]() {
+        NullSink output;
+        SVG::Writer writer(output, SVG::Precision::Two);
+        generator.SvgSymbols(writer, branches, size, size, SVG::Metadata());
+        return output.bytes();
+    });
+    for (bool symbols : {false, true}) {
+        Tree::ExportOptions options;
+        options.symbols = symbols;
+        options.precision = symbols ? SVG::Precision::Two : SVG::Precision::Full;
+        std::string name = std::string("ExportSvg") + (symbols ? " symbols " : " ") + std::to_string(pool.Size());
+        Measure(name + " workers (per shape)", shapes, [&]() {
+            NullSink output;
+            Tree::ExportSvg(output, generator, branches, size, size, SVG::Metadata(), pool, options);
+            return output.bytes();
+        });
+        std::string serial, parallel;
+        SVG::MemorySink serialSink(serial), parallelSink(parallel);
+        SVG::Writer writer(serialSink, options.precision);
+        if (symbols) {
+            generator.SvgSymbols(writer, branches, size, size, SVG::Metadata());
+        }
+        else {
+            generator.Svg(writer, branches, size, size, SVG::Metadata());
+        }
+        Tree::ExportSvg(parallelSink, generator, branches, size, size, SVG::Metadata(), pool, options);
+        if (serial != parallel) {
+            std::cerr << name << ": output differs from the serial export\n";
+        }
+    }
+    Measure("OnSaveTxT (per shape)", shapes, [&]() {
+        return generator.Txt(branches, size, size).size();
+    });
+
+    // Project round trip, the points are counted as operations
+    std::size_t points = 0;
+    for (auto &path : drawing.paths) {
+        points += path.points.size();
+    }
+    auto filename = (std::filesystem::temp_directory_path() / "SVG_TreeBenchmark.svgtree").string();
+    Measure("Project save (per point)", points, [&]() {
+        Tree::ProjectFile::Save(filename, drawing);
+        return static_cast<std::size_t>(std::filesystem::file_size(filename));
+    });
+    Tree::ProjectFile project;
+    Measure("Project open (per point)", points, [&]() {
+        project.Open(filename);
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < project.Paths(); i++) {
+            total += project.Points(i).size();
+        }
+        return total * sizeof(Tree::Point);
+    });
+    Tree::Drawing loaded;
+    Measure("Project load (per point)", points, [&]() {
+        project.Load(loaded);
+        return std::size_t(0);
+    });
+    project.Close();
+    std::filesystem::remove(filename);
+    std::vector<Tree::Branch> reloaded;
+    Measure("Project render (per leaf)", leafs, [&]() {
+        loaded.generator.Update(loaded.paths, reloaded);
+        return std::size_t(0);
+    });
+    if (generator.Txt(reloaded, size, size) != generator.Txt(branches, size, size)) {
+        std::cerr << "Project differs from the drawing\n";
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t maximum = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    Geometry();
+    Kernels(1000, 1000);
+    Strokes(100000);
+    Coordinates(1000000);
+    Profiling(1000000);
+    for (std::size_t leafs = 1000; leafs <= maximum; leafs *= 10) {
+        Drawing(leafs);
+    }
+
+    return 0;
+}
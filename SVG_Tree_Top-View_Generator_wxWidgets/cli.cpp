@@ -0,0 +1,202 @@
+/*
+ * Headless batch renderer: drawing files to SVG tree images in top view.
+ *
+ * Usage:
+ *
+ *      SVG_TreeBatch <file or directory> [-o output directory] [-j workers] [-p integer|1|2|full] [-l leafs file] [-s] [-t trace]
+ *
+ * -s writes each leaf as a <use> of its template (see Tree::Generator::SvgSymbols).
+ * -t saves the timed phases as a Chrome trace (see Tree::Profiler) and prints their summary.
+ * Files are rendered in parallel, a single file is exported in parallel chunks (see Tree::ExportSvg).
+ * Each drawing file (see Tree::Drawing) or binary project (*.svgtree, see Tree::ProjectFile) is streamed
+ * to an SVG file with the same name.
+ *
+ */
+
+#include "arena.h"
+#include "exporter.h"
+#include "profiler.h"
+#include "project.h"
+#include "threadPool.h"
+#include "tree.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+auto Render(const fs::path &input, const fs::path &output, const SVG::Metadata &metadata,
+            const Tree::ExportOptions &options, Tree::ArenaPool &arenas, Tree::ThreadPool *pool = nullptr) -> bool
+{
+    Tree::Drawing drawing;
+    auto ok = input.extension() == Tree::ProjectFile::Extension ? Tree::ReadProject(input.string(), drawing)
+              : Tree::ReadDrawing(input.string(), drawing);
+    if (!ok) {
+        return false;
+    }
+
+    // Geometry in an arena left by a previous job, freed at once
+    auto arena = arenas.Get();
+    std::vector<Tree::Branch> branches;
+    SVG::FileSink file(output.string());
+    auto &generator = drawing.generator;
+    if (pool) {
+        {
+            Tree::Profiler::Scope scope(Tree::Profiler::Phase::Update);
+            generator.Update(drawing.paths, branches, *pool, {}, arena.get());
+        }
+        auto ok = Tree::ExportSvg(file, generator, branches, drawing.width, drawing.height, metadata, *pool, options);
+        return file.close() && ok;
+    }
+
+    {
+        Tree::Profiler::Scope scope(Tree::Profiler::Phase::Update);
+        generator.Update(drawing.paths, branches, arena.get());
+    }
+    Tree::Profiler::Scope scope(Tree::Profiler::Phase::Export);
+    SVG::Writer writer(file, options.precision);
+    if (options.symbols) {
+        generator.SvgSymbols(writer, branches, drawing.width, drawing.height, metadata);
+    }
+    else {
+        generator.Svg(writer, branches, drawing.width, drawing.height, metadata);
+    }
+    Tree::Profiler::Add(Tree::Profiler::Counter::Bytes, file.bytes());
+
+    return file.close();
+}
+
+int main(int argc, char *argv[])
+{
+    fs::path source;
+    fs::path target;
+    std::string trace;
+    unsigned workers = std::thread::hardware_concurrency();
+    Tree::ExportOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            target = argv[++i];
+        }
+        else if (arg == "-j" && i + 1 < argc) {
+            std::string value = argv[++i];
+            auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), workers);
+            if (error != std::errc() || end != value.data() + value.size() || workers == 0) {
+                source.clear();     // usage
+                break;
+            }
+        }
+        else if (arg == "-p" && i + 1 < argc) {
+            std::string value = argv[++i];
+            options.precision = value == "integer" ? SVG::Precision::Integer :
+                        value == "1" ? SVG::Precision::One :
+                        value == "2" ? SVG::Precision::Two : SVG::Precision::Full;
+        }
+        else if (arg == "-l" && i + 1 < argc) {
+            if (!Tree::LeafTemplate::Load(argv[++i])) {
+                std::cerr << "Invalid leafs file: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "-s") {
+            options.symbols = true;
+        }
+        else if (arg == "-t" && i + 1 < argc) {
+            trace = argv[++i];
+        }
+        else if (source.empty() && arg[0] != '-') {
+            source = arg;
+        }
+        else {
+            source.clear();
+            break;
+        }
+    }
+
+    if (source.empty()) {
+        std::cerr << "Usage: " << argv[0] << " <file or directory> [-o output directory] [-j workers] [-p integer|1|2|full] [-l leafs file] [-s] [-t trace]\n";
+        return 1;
+    }
+
+    // Jobs
+    std::vector<fs::path> jobs;
+    try {
+        if (fs::is_directory(source)) {
+            for (auto &entry : fs::directory_iterator(source)) {
+                if (entry.is_regular_file() && entry.path().extension() != ".svg") {
+                    jobs.push_back(entry.path());
+                }
+            }
+            std::sort(jobs.begin(), jobs.end());
+        }
+        else {
+            jobs.push_back(source);
+        }
+        if (!target.empty()) {
+            fs::create_directories(target);
+        }
+    }
+    catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    // Same date for every file, SVG::svg is not called from the main thread.
+    SVG::Metadata metadata;
+    std::time_t t = std::time(nullptr);
+    metadata.date = std::to_string(1900 + std::localtime(&t)->tm_year);
+
+    if (!trace.empty()) {
+        Tree::Profiler::StartTrace();
+    }
+    std::atomic<unsigned> failed = 0;
+    auto start = std::chrono::steady_clock::now();
+    {
+        Tree::ThreadPool pool(workers);
+        Tree::ArenaPool arenas;
+        auto render = [&](const fs::path & job, Tree::ThreadPool * chunks) {
+            auto output = (target.empty() ? job.parent_path() : target) / job.filename().replace_extension(".svg");
+            try {
+                if (!Render(job, output, metadata, options, arenas, chunks)) {
+                    failed++;
+                }
+            }
+            catch (const std::exception &e) {
+                std::cerr << job.string() << ": " << e.what() << "\n";
+                failed++;
+            }
+        };
+        if (jobs.size() == 1) {
+            render(jobs.front(), &pool);    // one file, exported in parallel chunks
+        }
+        else {
+            for (auto &job : jobs) {
+                pool.Push([&, job]() { render(job, nullptr); });
+            }
+        }
+        pool.Wait();
+        workers = pool.Size();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    auto done = jobs.size() - failed;
+    std::cout << done << " of " << jobs.size() << " trees in " << elapsed.count() << " s with "
+              << workers << " workers : " << (elapsed.count() > 0 ? done / elapsed.count() : 0.0)
+              << " trees/s\n";
+    if (!trace.empty()) {
+        std::cout << Tree::Profiler::Summary() << "\n";
+        if (!Tree::Profiler::StopTrace(trace)) {
+            return 1;
+        }
+    }
+
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+#include "detail.h"
+
+#include <algorithm>
+
+namespace Tree {
+
+void DetailLevel::SetEnabled(bool value)
+{
+    isEnabled = value;
+    scale = 1;
+    isBlob = false;
+}
+
+auto DetailLevel::Frame(double milliseconds) -> bool
+{
+    if (!isEnabled) {
+        return false;
+    }
+
+    // Coarser at once, finer step by step: a frame near the budget does not switch back and forth
+    if (milliseconds > budget) {
+        if (scale < MaxScale) {
+            scale *= 2;
+            return true;
+        }
+        if (!isBlob) {
+            isBlob = true;
+            return true;
+        }
+    }
+    else if (milliseconds < budget / 4) {
+        if (isBlob) {
+            isBlob = false;
+            return true;
+        }
+        if (scale > 1) {
+            scale /= 2;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+auto Coarse(std::span<const Point> points, Point *out) -> std::size_t
+{
+    if (points.size() <= 4) {
+        std::copy(points.begin(), points.end(), out);
+        return points.size();
+    }
+
+    // Tip: the farthest vertex from the base
+    auto base = points.front();
+    auto tip = base;
+    long long farthest = 0;
+    for (auto &point : points) {
+        long long dx = point.x - base.x;
+        long long dy = point.y - base.y;
+        if (dx * dx + dy * dy > farthest) {
+            farthest = dx * dx + dy * dy;
+            tip = point;
+        }
+    }
+
+    // Widest vertices, by the cross product with the axis
+    long long ax = tip.x - base.x;
+    long long ay = tip.y - base.y;
+    long long left = 0, right = 0;
+    Point leftPoint, rightPoint;
+    for (auto &point : points) {
+        auto cross = ax * (point.y - base.y) - ay * (point.x - base.x);
+        if (cross > left) {
+            left = cross;
+            leftPoint = point;
+        }
+        if (cross < right) {
+            right = cross;
+            rightPoint = point;
+        }
+    }
+
+    std::size_t count = 0;
+    out[count++] = base;
+    if (left > 0) {
+        out[count++] = leftPoint;
+    }
+    if (farthest > 0) {
+        out[count++] = tip;
+    }
+    if (right < 0) {
+        out[count++] = rightPoint;
+    }
+
+    return count;
+}
+
+} // namespace Tree
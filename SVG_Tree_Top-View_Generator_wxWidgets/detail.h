@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include "tree.h"
+
+/*
+ * Level of detail of the leafs on screen.
+ *
+ * A leaf a few pixels long is drawn as a coarse polygon, a smaller one as its bounding box. The lengths grow while
+ * the frames take longer than the budget and shrink back once they are well under it. At the largest lengths,
+ * still over the budget, runs of the smallest leafs of a branch are drawn as one blob.
+ *
+ * Only the screen uses it: the exports always have every vertex.
+ */
+namespace Tree {
+
+enum class Detail : unsigned char { Full, Coarse, Dot, Blob };
+
+class DetailLevel {
+public:
+    static constexpr std::size_t BlobLeafs = 16;    // leafs of a blob at most
+
+    // Milliseconds of a full frame.
+    explicit DetailLevel(double budget = 16) : budget(budget) {}
+
+    [[nodiscard]] auto Enabled() const -> bool { return isEnabled; }
+    void SetEnabled(bool value);
+
+    [[nodiscard]] auto Budget() const -> double { return budget; }
+    void SetBudget(double value) { budget = value; }
+
+    // Detail of a leaf of this length on screen, in pixels.
+    [[nodiscard]] auto Get(double length) const -> Detail
+    {
+        if (!isEnabled || length >= CoarseLength * scale) {
+            return Detail::Full;
+        }
+        if (length >= DotLength * scale) {
+            return Detail::Coarse;
+        }
+        return isBlob ? Detail::Blob : Detail::Dot;
+    }
+
+    // Time of a full frame, returns true if the detail changed.
+    auto Frame(double milliseconds) -> bool;
+
+    // Growth of the lengths, 1 while the frames are within the budget.
+    [[nodiscard]] auto Scale() const -> double { return scale; }
+
+private:
+    static constexpr double CoarseLength = 6;
+    static constexpr double DotLength = 2;
+    static constexpr double MaxScale = 16;
+
+    double budget;
+    double scale = 1;
+    bool isBlob = false;
+    bool isEnabled = true;
+};
+
+// Base, tip and widest vertex on each side of a leaf, up to 4 vertices written to out. Returns their number.
+auto Coarse(std::span<const Point> points, Point *out) -> std::size_t;
+
+} // namespace Tree
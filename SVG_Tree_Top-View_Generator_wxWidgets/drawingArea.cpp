@@ -2,26 +2,21 @@
 
 #include "wx/dcsvg.h"
 
-inline wxPoint angularCoordinate(unsigned lenght, unsigned angle)
-{
-    // Origin: (0,0)
-    return wxPoint(Cos(0, lenght, angle), Sin(0, lenght, angle));
-}
-
-inline wxPoint angularCoordinate(wxPoint p, unsigned lenght, unsigned angle)
-{
-    // Origin: Point
-    return wxPoint(Cos(p.x, lenght, angle), Sin(p.y, lenght, angle));
-}
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <ctime>
+#include <filesystem>
+#include <memory>
 
-inline wxPoint angularCoordinate(double x, double y, unsigned lenght, unsigned angle)
-{
-    // Origin: (x,y)
-    return wxPoint(Cos(x, lenght, angle), Sin(y, lenght, angle));
-}
+#include "exporter.h"
+#include "project.h"
 
 DrawingArea::DrawingArea(wxFrame *parent, int id, wxPoint position, wxSize size)
-    : wxPanel(parent, id, position, size)
+    : wxPanel(parent, id, position, size),
+      rebuilder(rebuildPool, [this](std::shared_ptr<Tree::Rebuilder::Result> result) {
+          CallAfter([this, result]() { OnRebuilt(result); });
+      }, arenas)
 {
     // Cursor
     cursorRadius = 5;
@@ -32,46 +27,189 @@ DrawingArea::DrawingArea(wxFrame *parent, int id, wxPoint position, wxSize size)
     colorBorderPen = wxColour(255, 0, 0, 255);
     colorCursorBrush = wxColour(0, 0, 0, 255);
     colorCursorPen = wxColour(0, 0, 0, 255);
-    colorLineBrush = wxColour(0, 0, 0, 255);
-    colorLinePen = wxColour(0, 0, 0, 255);
-    colorShapeBrush = wxColour(0, 0, 0, 255);
-    colorShapePen = wxColour(0, 0, 0, 255);
-    minColorShapeBrush = colorShapeBrush;
-    maxColorShapeBrush = colorShapeBrush;
-    randomColorShapeBrush = false;
 
     // State of the drawing
+    frame = parent;
+    isExporting = false;
     currentSize = size;
     isDrawing = true;
     maxSize = size;
     path.clear();
+    grid.reset(size.x, size.y);
+    viewport.SetCanvas(size.x, size.y);
+    viewport.SetView(size.x, size.y);
+    isPanning = false;
+    isRebuilding = false;
+    hoveredPath = -1;
+    frameNumber = 0;
+    history.SetBudget(UndoBudget);
+    isStroke = false;
+    strokeStart = 0;
+    isCacheGrid = false;
+    isCacheValid = false;
 
     // Draw
     breakPath = true;
-    isSpline = false;
+    generator.isSpline = false;
+    generator.lineWidth = 10;
     limitLength = 20;
-    lineWidth = 10;
     panelBorder = 20;
+    regenerated = 0;
+    seed = std::random_device()();
     shapeAngle = 60;
+    simplifier.SetTolerance(1);
     shapeLenght = 50;
 
     // Handlers
     Bind(wxEVT_LEFT_DOWN, &DrawingArea::OnMouseClicked, this, id);
     Bind(wxEVT_LEFT_UP, &DrawingArea::OnMouseClicked, this, id);
     Bind(wxEVT_MOTION, &DrawingArea::OnMouseClicked, this, id);
+    Bind(wxEVT_MIDDLE_DOWN, &DrawingArea::OnMouseView, this, id);
+    Bind(wxEVT_MIDDLE_UP, &DrawingArea::OnMouseView, this, id);
+    Bind(wxEVT_MOUSE_CAPTURE_LOST, [ = ](wxMouseCaptureLostEvent &) {
+        isPanning = false;  // Alt-Tab or a dialog during a pan
+    }, id);
+    Bind(wxEVT_MOUSEWHEEL, &DrawingArea::OnMouseView, this, id);
     Bind(wxEVT_PAINT, &DrawingArea::OnPaint, this, id);
-    Bind(wxEVT_SIZE, [ = ](wxSizeEvent &) { Refresh(); }, id);
+    Bind(wxEVT_SIZE, [ = ](wxSizeEvent &) {
+        viewport.SetView(GetSize().x, GetSize().y);
+        Refresh();
+    }, id);
 }
 
 void DrawingArea::OnPaint(wxPaintEvent &event)
 {
     wxPaintDC dc(this);
+    if (GetSize().x <= 0 || GetSize().y <= 0) {
+        return;
+    }
+    {
+        Tree::Profiler::Scope scope(Tree::Profiler::Phase::Paint);
+        OnPaint(dc);
+    }
+    if (Tree::Profiler::Enabled()) {
+        frame->SetStatusText(Tree::Profiler::Summary(), 1);
+    }
+}
+
+void DrawingArea::OnPaint(wxDC &dc)
+{
+    // The tiles are drawn only after a change, every paint copies the visible ones and adds the cursor
+    auto isGrid = isDrawing || path.empty();
+    if (!isCacheValid || isGrid != isCacheGrid) {
+        for (auto &[key, tile] : tiles) {
+            tile.isValid = false;
+        }
+        isCacheGrid = isGrid;
+        isCacheValid = true;
+    }
+    cacheDirty = Tree::Box();
+
+    // Outside of the canvas
+    auto update = GetUpdateRegion().GetBox();
+    dc.SetPen(*wxTRANSPARENT_PEN);
+    dc.SetBrush(wxBrush(wxColour(200, 200, 200)));
+    dc.DrawRectangle(update);
+
+    auto zoom = viewport.Zoom();
+    auto range = viewport.Tiles();
+    auto canvas = wxRect(0, 0, currentSize.x, currentSize.y);
+    double elapsed = 0;
+    bool isFull = false;
+    frameNumber++;
+    for (int row = range.min.y; row <= range.max.y; row++) {
+        for (int column = range.min.x; column <= range.max.x; column++) {
+            auto corner = viewport.TileScreen(column, row);
+            auto size = Tree::Viewport::TileSize;
+            if (!update.Intersects(wxRect(corner.x, corner.y, size, size))) {
+                continue;
+            }
+            auto &tile = GetTile(column, row);
+            tile.used = frameNumber;
+
+            // Logical coordinates on the tile
+            wxMemoryDC memoryDC(tile.bitmap);
+            memoryDC.SetUserScale(zoom, zoom);
+            memoryDC.SetDeviceOrigin(-column * size, -row * size);
+            auto area = viewport.TileArea(column, row);
+            if (!tile.isValid) {
+                tile.dirty = area;
+            }
+            if (!tile.dirty.empty()) {
+                auto start = std::chrono::steady_clock::now();
+                wxRect dirty(wxPoint(tile.dirty.min.x, tile.dirty.min.y), wxPoint(tile.dirty.max.x, tile.dirty.max.y));
+                memoryDC.SetClippingRegion(dirty);
+                memoryDC.SetPen(*wxTRANSPARENT_PEN);
+                memoryDC.SetBrush(wxBrush(wxColour(200, 200, 200)));
+                memoryDC.DrawRectangle(dirty);
+                memoryDC.SetBrush(wxBrush(GetBackgroundColour()));
+                memoryDC.DrawRectangle(canvas);
+                OnDrawTree(memoryDC);
+                memoryDC.DestroyClippingRegion();
+                elapsed += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                isFull = isFull || !tile.isValid;
+                tile.isValid = true;
+                tile.dirty = Tree::Box();
+            }
+            memoryDC.SetUserScale(1, 1);
+            memoryDC.SetDeviceOrigin(0, 0);
+            dc.Blit(corner.x, corner.y, size, size, &memoryDC, 0, 0);
+        }
+    }
+    // The time of the tiles drawn from scratch sets the detail of the next ones
+    if (isFull) {
+        level.Frame(elapsed);
+    }
+
+    // Least recently painted tiles out of the cache
+    while (tiles.size() > MaxTiles) {
+        auto oldest = tiles.begin();
+        for (auto it = tiles.begin(); it != tiles.end(); it++) {
+            if (it->second.used < oldest->second.used) {
+                oldest = it;
+            }
+        }
+        if (oldest->second.used == frameNumber) {
+            break;
+        }
+        tiles.erase(oldest);
+    }
+
+    dc.SetUserScale(zoom, zoom);
+    dc.SetDeviceOrigin(-viewport.ScrollX(), -viewport.ScrollY());
     dc.SetPen(wxNullPen);
     dc.SetBrush(wxNullBrush);
-    OnDraw(dc);
+    OnDrawCursor(dc);
+}
+
+DrawingArea::Tile &DrawingArea::GetTile(int column, int row)
+{
+    auto key = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(column)) << 32) | static_cast<std::uint32_t>(row);
+    auto &tile = tiles[key];
+    if (!tile.bitmap.IsOk()) {
+        tile.bitmap.Create(Tree::Viewport::TileSize, Tree::Viewport::TileSize);
+        tile.column = column;
+        tile.row = row;
+        tile.isValid = false;
+    }
+
+    return tile;
+}
+
+wxRect DrawingArea::ToScreen(const Tree::Box &box)
+{
+    auto screen = viewport.ToScreen(box);
+
+    return wxRect(wxPoint(screen.min.x, screen.min.y), wxPoint(screen.max.x, screen.max.y));
 }
 
 void DrawingArea::OnDraw(wxDC &dc)
+{
+    OnDrawCursor(dc);
+    OnDrawTree(dc, false);
+}
+
+void DrawingArea::OnDrawCursor(wxDC &dc)
 {
     // Cursor
     dc.SetPen(colorCursorPen);
@@ -88,186 +226,550 @@ void DrawingArea::OnDraw(wxDC &dc)
                         cursorPosition.x, cursorPosition.y);
         }
     }
+}
+
+void DrawingArea::OnDrawTree(wxDC &dc, bool isScreen)
+{
+    Tree::Profiler::Scope scope(Tree::Profiler::Phase::Draw);
+
+    // Only the shapes found in the clipping box are drawn, the box grows by the widest stroke
+    wxCoord x = 0, y = 0, width = 0, height = 0;
+    dc.GetClippingBox(&x, &y, &width, &height);
+    auto isClipped = width > 0 && height > 0;
+    int margin = generator.lineWidth + 1;
+    Tree::Box clip(Tree::Point(x - margin, y - margin), Tree::Point(x + width + margin, y + height + margin));
+
     // Grade
     if (isDrawing || path.empty()) {
         // Border
         dc.SetPen(colorBorderPen);
         dc.SetBrush(colorBorderBrush);
-        dc.DrawRectangle(panelBorder, panelBorder, GetSize().x - 2 * panelBorder, GetSize().y - 2 * panelBorder);
+        dc.DrawRectangle(panelBorder, panelBorder, currentSize.x - 2 * panelBorder, currentSize.y - 2 * panelBorder);
         // Center
-        dc.DrawLine(GetSize().x / 2, 0, GetSize().x / 2, GetSize().y);
-        dc.DrawLine(0, GetSize().y / 2, GetSize().x, GetSize().y / 2);
+        dc.DrawLine(currentSize.x / 2, 0, currentSize.x / 2, currentSize.y);
+        dc.DrawLine(0, currentSize.y / 2, currentSize.x, currentSize.y / 2);
     }
+    // Pens and brushes only when they change, most leafs of a branch share them
+    constexpr unsigned noPen = UINT_MAX;
+    bool isPen = false, isBrush = false;
+    Tree::Colour currentPen, currentBrush;
+    unsigned currentWidth = 0;
+    auto setPen = [&](Tree::Colour pen, unsigned lineWidth) {
+        if (!isPen || pen != currentPen || lineWidth != currentWidth) {
+            dc.SetPen(lineWidth != noPen ? wxPen(wxColour(pen.red, pen.green, pen.blue, pen.alpha), lineWidth)
+                                         : *wxTRANSPARENT_PEN);
+            currentPen = pen;
+            currentWidth = lineWidth;
+            isPen = true;
+        }
+    };
+    auto setBrush = [&](Tree::Colour brush) {
+        if (!isBrush || brush != currentBrush) {
+            dc.SetBrush(wxColour(brush.red, brush.green, brush.blue, brush.alpha));
+            currentBrush = brush;
+            isBrush = true;
+        }
+    };
+
     // Shapes
-    for (auto &shape : shapes) {
-        dc.SetPen(wxPen(shape.pen, shape.lineWidth));
-        dc.SetBrush(shape.brush);
-        if (isSpline) {
-            dc.DrawSpline(shape.points.size(), &shape.points[0]);
+    auto draw = [&](Tree::ShapeKind kind, Tree::Colour pen, Tree::Colour brush, unsigned lineWidth,
+                    std::span<const Tree::Point> points) {
+        buffer.clear();
+        for (auto &point : points) {
+            buffer.push_back(wxPoint(point.x, point.y));
+        }
+        setPen(pen, lineWidth);
+        setBrush(brush);
+        if (generator.isSpline) {
+            dc.DrawSpline(buffer.size(), &buffer[0]);
         }
         else {
-            if (shape.name == "Line") {
-                dc.DrawLines(shape.points.size(), &shape.points[0]);
+            if (kind == Tree::ShapeKind::Line) {
+                dc.DrawLines(buffer.size(), &buffer[0]);
             }
             else {
-                dc.DrawPolygon(shape.points.size(), &shape.points[0]);
+                dc.DrawPolygon(buffer.size(), &buffer[0]);
             }
         }
+    };
+    auto drawLine = [&](const Tree::Branch & branch) {
+        if (generator.IsVisible(branch)) {
+            auto &line = branch.line;
+            draw(line.kind, line.pen, line.brush, line.lineWidth, line.points);
+        }
+    };
+
+    // Small leafs by their length on screen, the smallest ones of a branch gathered in blobs
+    Tree::Box blob;
+    std::size_t blobLeafs = 0;
+    auto drawBlob = [&]() {
+        if (blobLeafs > 0) {
+            setPen(Tree::Colour(), noPen);
+            dc.DrawEllipse(blob.min.x, blob.min.y, blob.max.x - blob.min.x + 1, blob.max.y - blob.min.y + 1);
+            blob = Tree::Box();
+            blobLeafs = 0;
+        }
+    };
+    auto zoom = viewport.Zoom();
+    auto drawLeaf = [&](const Tree::Branch & branch, std::size_t i) {
+        auto &leafs = branch.leafs;
+        auto detail = isScreen && i < branch.placements.size() ? level.Get(branch.placements[i].lenght * zoom)
+                      : Tree::Detail::Full;
+        if (detail != Tree::Detail::Blob) {
+            drawBlob();
+        }
+        switch (detail) {
+        case Tree::Detail::Coarse: {
+            Tree::Point points[4];
+            auto count = Tree::Coarse(leafs.points(i), points);
+            draw(Tree::ShapeKind::Polygon, leafs.pen(i), leafs.brush(i), leafs.lineWidth(i), {points, count});
+            break;
+        }
+        case Tree::Detail::Dot: {
+            auto &box = leafs.bounds(i);
+            setPen(Tree::Colour(), noPen);
+            setBrush(leafs.brush(i));
+            dc.DrawRectangle(box.min.x, box.min.y, box.max.x - box.min.x + 1, box.max.y - box.min.y + 1);
+            break;
+        }
+        case Tree::Detail::Blob:
+            if (blobLeafs == 0) {
+                setBrush(leafs.brush(i));
+            }
+            blob.add(leafs.bounds(i));
+            if (++blobLeafs == Tree::DetailLevel::BlobLeafs) {
+                drawBlob();
+            }
+            break;
+        default:
+            draw(leafs.kind(i), leafs.pen(i), leafs.brush(i), leafs.lineWidth(i), leafs.points(i));
+            break;
+        }
+    };
+    if (!isClipped) {
+        for (auto &branch : branches) {
+            for (std::size_t i = 0; i < branch.leafs.size(); i++) {
+                drawLeaf(branch, i);
+            }
+            drawBlob();
+            drawLine(branch);
+        }
+        return;
     }
+
+    // Drawing order: branches in order, leafs before the line, the line once
+    visible.clear();
+    grid.query(clip, visible);
+    std::sort(visible.begin(), visible.end(), [](const Tree::SpatialGrid::Entry & a, const Tree::SpatialGrid::Entry & b) {
+        return a.branch != b.branch ? a.branch < b.branch : a.shape < b.shape;
+    });
+    for (std::size_t i = 0; i < visible.size(); i++) {
+        auto &entry = visible[i];
+        if (entry.branch >= branches.size()) {
+            continue;
+        }
+        auto &branch = branches[entry.branch];
+        if (i > 0 && visible[i - 1].branch != entry.branch) {
+            drawBlob();
+        }
+        if (entry.shape & Tree::SpatialGrid::Line) {
+            drawBlob();
+            drawLine(branch);
+            while (i + 1 < visible.size() && visible[i + 1].branch == entry.branch) {
+                i++;
+            }
+        }
+        else if (entry.shape < branch.leafs.size()) {
+            drawLeaf(branch, entry.shape);
+        }
+    }
+    drawBlob();
 };
 
 void DrawingArea::OnUpdate()
 {
-    shapes.clear();
-    std::vector<wxPoint> pointsLine;
-
-    // Leafs
-    wxPoint currentPoint;
-    for (auto &line : path) { // check all branches
-        if (line.shapeLenght > 0) {  // non-transparent leaf
-            currentPoint = line.points.back();  // last branch point
-            for (unsigned i = line.points.size() - 1; i > 0; i--) {  // check all branch points
-                auto distance = Distance(currentPoint.x, currentPoint.y, line.points[i].x, line.points[i].y);
-                if (distance > line.limitLength) { // distance greater than expected range
-                    // Segment angle
-                    auto lineAngle = LineAngle(currentPoint.x, currentPoint.y, line.points[i].x, line.points[i].y);
-                    // Number of intermediate points in the segment
-                    unsigned num = distance / line.limitLength;
-                    for (unsigned j = 0; j < num; j++) {  // build intermediate points if necessary
-                        // Fill color
-                        if (randomColorShapeBrush) {
-                            unsigned r = maxColorShapeBrush.Red() - minColorShapeBrush.Red();
-                            unsigned g = maxColorShapeBrush.Green() - minColorShapeBrush.Green();
-                            unsigned b = maxColorShapeBrush.Blue() - minColorShapeBrush.Blue();
-                            r = r > 0 ? rand() % r : 0;
-                            g = g > 0 ? rand() % g : 0;
-                            b = b > 0 ? rand() % b : 0;
-                            colorShapeBrush = wxColour((minColorShapeBrush.Red() + r) % 255,
-                                                       (minColorShapeBrush.Green() + g) % 255,
-                                                       (minColorShapeBrush.Blue() + b) % 255);
-                        }
-                        // Current leafs
-                        wxPoint point;
-                        point = currentPoint - angularCoordinate(j * line.limitLength, lineAngle);
-                        for (auto &signal : {-1, 1}) {
-                            auto angle = lineAngle + signal * line.shapeAngle;
-                            auto points = GetPoints(line.shapeNumber,
-                                                    point + angularCoordinate(lineWidth, angle), line.shapeLenght, angle);
-                            // Save structure
-                            shapes.push_back(Shape(isSpline ? "Spline" : "Polygon", colorShapePen, colorShapeBrush, 1, points));
-                        }
-                    }
-                    // Next segment
-                    currentPoint = line.points[i];
-                }
-                // Branch points
-                pointsLine.push_back(line.points[i]);
+    // Full rebuild, required when global parameters change
+    Tree::Profiler::Scope scope(Tree::Profiler::Phase::Update);
+    if (isRebuilding) {
+        rebuilder.Cancel();
+        isRebuilding = false;
+    }
+    // The geometry of the previous rebuild is kept by the history if an edit waits for it, else dropped at once
+    // and its arena reused
+    history.Keep({std::move(arena), std::move(branches)});
+    arena = arenas.Get();
+    regenerated = generator.Update(path, branches, pool, {}, arena.get());
+    grid.build(branches);
+    isCacheValid = false;
+}
+
+void DrawingArea::RequestUpdate()
+{
+    // Full rebuild in the background, the current branches are shown until it is done
+    isRebuilding = true;
+    rebuilder.Request(generator, path);
+}
+
+void DrawingArea::FinishUpdate()
+{
+    // The branches must match the paths before they are edited or saved
+    if (isRebuilding) {
+        OnUpdate();
+        ResumeStroke();
+    }
+}
+
+void DrawingArea::OnRebuilt(std::shared_ptr<Tree::Rebuilder::Result> result)
+{
+    if (!isRebuilding || result->generation != rebuilder.Generation()) {
+        return;     // stale
+    }
+    history.Keep({std::move(arena), std::move(branches)});
+    branches = std::move(result->branches);
+    arena = std::move(result->arena);
+    regenerated = result->count;
+    grid.build(branches);
+    isCacheValid = false;
+    isRebuilding = false;
+    ResumeStroke();
+    Refresh();
+}
+
+void DrawingArea::OnUpdate(unsigned index, bool incremental)
+{
+    Tree::Profiler::Scope scope(Tree::Profiler::Phase::Update);
+    regenerated = 0;
+    if (index < path.size()) {
+        branches.resize(path.size());
+        auto &branch = branches[index];
+        if (!incremental) {
+            Invalidate(branch.bounds);  // previous shapes of the branch
+            grid.erase(index, branch);
+        }
+        // A branch of a full rebuild would grow in its arena, where nothing is freed until the arena is: it is
+        // moved to the default memory first, copied if it is extended
+        if (branch.placements.get_allocator().resource() != std::pmr::get_default_resource()) {
+            auto moved = incremental ? Tree::Branch(branch) : Tree::Branch();
+            std::destroy_at(&branch);
+            std::construct_at(&branch, std::move(moved));
+        }
+        auto leafs = incremental ? branch.leafs.size() : 0;
+        auto points = incremental && !branch.line.points.empty() ? branch.line.points.size() - 1 : 0;
+        regenerated = generator.Update(path[index], branch, incremental);
+        grid.insert(index, branch, leafs, points);
+
+        // New leafs and branch segments
+        Tree::Box box;
+        for (auto i = leafs; i < branch.leafs.size(); i++) {
+            box.add(branch.leafs.bounds(i));
+        }
+        for (auto i = points; i < branch.line.points.size(); i++) {
+            box.add(branch.line.points[i]);
+        }
+        Invalidate(box);
+    }
+}
+
+void DrawingArea::Invalidate(const Tree::Box &box)
+{
+    if (!box.empty()) {
+        int margin = generator.lineWidth + 1;
+        Tree::Box area(Tree::Point(box.min.x - margin, box.min.y - margin),
+                       Tree::Point(box.max.x + margin, box.max.y + margin));
+        cacheDirty.add(area);
+        for (auto &[key, tile] : tiles) {
+            if (tile.isValid && viewport.TileArea(tile.column, tile.row).intersects(area)) {
+                tile.dirty.add(area);
             }
         }
-        // Current branch
-        if (pointsLine.size() > 1 && lineWidth > 0) {
-            // Save structure
-            shapes.push_back(Shape("Line", colorLinePen, colorLineBrush, lineWidth, pointsLine));
+    }
+}
+
+Tree::Box DrawingArea::GetCursorArea()
+{
+    // Cursor circle, first point of the path and line to the cursor
+    int margin = cursorRadius + 2;
+    Tree::Box area;
+    auto add = [&](wxPoint point) {
+        area.add(Tree::Box(Tree::Point(point.x - margin, point.y - margin), Tree::Point(point.x + margin, point.y + margin)));
+    };
+    add(cursorPosition);
+    if (!path.empty() && !path.back().points.empty()) {
+        auto &first = path.back().points.front();
+        auto &last = path.back().points.back();
+        add(wxPoint(first.x, first.y));
+        if (!breakPath) {
+            add(wxPoint(last.x, last.y));
         }
-        // Prepare for the next branch
-        pointsLine.clear();
     }
+
+    return area;
 }
 
 void DrawingArea::OnMouseClicked(wxMouseEvent &event)
 {
-    cursorPosition = ScreenToClient(::wxGetMousePosition());
-    if (cursorPosition.x > panelBorder && cursorPosition.x < GetSize().x - panelBorder &&
-        cursorPosition.y > panelBorder && cursorPosition.y < GetSize().y - panelBorder) {
+    auto mouse = ScreenToClient(::wxGetMousePosition());
+    if (isPanning) {
+        viewport.Pan(panPosition.x - mouse.x, panPosition.y - mouse.y);
+        panPosition = mouse;
+        Refresh();
+        return;
+    }
+
+    auto logical = viewport.ToLogical(mouse.x, mouse.y);
+    cursorPosition = wxPoint(logical.x, logical.y);
+    if (cursorPosition.x > panelBorder && cursorPosition.x < currentSize.x - panelBorder &&
+        cursorPosition.y > panelBorder && cursorPosition.y < currentSize.y - panelBorder) {
         if (event.LeftDown()) {
+            FinishUpdate();
+            CommitStroke();
             isDrawing = true;
+            isStroke = true;
+            strokeStart = path.empty() || breakPath ? 0 : path.back().points.size();
             if (path.empty() || breakPath) {
-                path.push_back(Path(cursorPosition, shapeNumber, shapeAngle, shapeLenght, limitLength));
+                simplifier.Begin(limitLength);
+                path.push_back(Tree::Path(Tree::Point(cursorPosition.x, cursorPosition.y),
+                                      shapeNumber, shapeAngle, shapeLenght, limitLength,
+                                      static_cast<unsigned>(Tree::Random(seed, path.size()))));
+                OnUpdate(path.size() - 1);
                 breakPath = false;
             }
         }
         if (isDrawing && event.LeftIsDown()) {
-            if (!path.empty()) {
-                path.back().points.push_back(cursorPosition);
-                OnUpdate();
+            if (!path.empty() && simplifier.Add(Tree::Point(cursorPosition.x, cursorPosition.y), path.back().points)) {
+                OnUpdate(path.size() - 1, true);
             }
         }
         if (event.LeftUp()) {
+            CommitStroke();
             isDrawing = false;
         }
-        if (event.Moving() && !randomColorShapeBrush) {
-            randomColorShapeBrush = false;
+        if (event.Moving() && !generator.randomColorShapeBrush) {
+            generator.randomColorShapeBrush = false;
+        }
+    }
+
+    // Path under the cursor in the status bar, written only when it changes
+    if (event.Moving()) {
+        auto hovered = GetPathAt(mouse);
+        if (hovered != hoveredPath) {
+            hoveredPath = hovered;
+            frame->SetStatusText(hovered < 0 ? wxString() : wxString::Format("Path: %d", hovered + 1));
+        }
+    }
+
+    // Only the areas that changed are painted again
+    auto area = ToScreen(GetCursorArea());
+    if (!isCacheValid || (isDrawing || path.empty()) != isCacheGrid) {
+        Refresh();
+    }
+    else {
+        RefreshRect(wxRect(cursorArea).Union(area));
+        if (!cacheDirty.empty()) {
+            RefreshRect(ToScreen(cacheDirty));
+        }
+    }
+    cursorArea = area;
+}
+
+void DrawingArea::OnMouseView(wxMouseEvent &event)
+{
+    auto mouse = event.GetPosition();
+    if (event.GetWheelRotation() != 0) {
+        auto steps = event.GetWheelRotation() / std::max(event.GetWheelDelta(), 1);
+        viewport.ZoomAt(std::pow(1.25, steps), mouse.x, mouse.y);
+        OnViewChanged(true);
+    }
+    else if (event.MiddleDown()) {
+        isPanning = true;
+        panPosition = mouse;
+        CaptureMouse();
+    }
+    else if (event.MiddleUp() && isPanning) {
+        isPanning = false;
+        if (HasCapture()) {
+            ReleaseMouse();
         }
     }
+}
+
+void DrawingArea::OnViewChanged(bool isZoomed)
+{
+    // Tiles are cut from the zoomed canvas, a new zoom needs new ones
+    if (isZoomed) {
+        tiles.clear();
+        frame->SetStatusText(wxString::Format("Zoom: %.0f%%", 100 * viewport.Zoom()));
+    }
     Refresh();
 }
 
+void DrawingArea::Zoom(double factor)
+{
+    viewport.ZoomAt(factor, GetSize().x / 2, GetSize().y / 2);
+    OnViewChanged(true);
+}
+
+void DrawingArea::ZoomFit()
+{
+    viewport.Fit();
+    OnViewChanged(true);
+}
+
 void DrawingArea::BreakPath()
 {
+    CommitStroke();
     breakPath = true;
 }
 
+void DrawingArea::CommitStroke()
+{
+    // The stroke as one edit, once its last sample is in
+    if (isStroke) {
+        FinishStroke();
+        history.Stroke(path, path.size() - 1, strokeStart);
+        isStroke = false;
+    }
+}
+
+void DrawingArea::FinishStroke()
+{
+    // Last sample kept back by the simplifier
+    if (!path.empty() && simplifier.Finish(path.back().points)) {
+        OnUpdate(path.size() - 1, true);
+    }
+}
+
+void DrawingArea::ResumeStroke()
+{
+    // The next stroke may continue the last path, as it is after an undo or redo: its leafs go on from the anchor
+    // of its branch, known once the branch is generated
+    if (isStroke) {
+        return;
+    }
+    if (isRebuilding || path.empty() || branches.size() < path.size()) {
+        simplifier.Begin(path.empty() ? limitLength : path.back().limitLength);
+        return;
+    }
+    simplifier.Begin(path.back(), branches[path.size() - 1].anchor);
+}
+
 bool DrawingArea::Resize(wxSize newSize, bool reset)
 {
-    if (newSize.x < 100 || newSize.y < 100 || newSize.x > maxSize.x || newSize.y > maxSize.y) {
+    if (newSize.x < 100 || newSize.y < 100 || newSize.x > MaxCanvas || newSize.y > MaxCanvas) {
         return false;
     }
 
+    // The panel up to the screen size, the rest through the viewport
+    currentSize = newSize;
+    grid.reset(newSize.x, newSize.y);
+    grid.build(branches);
     if (reset) {
         OnReset();
     }
-
-    SetSize(newSize);
-    currentSize = newSize;
+    SetSize(wxSize(std::min(newSize.x, maxSize.x), std::min(newSize.y, maxSize.y)));
+    viewport.SetCanvas(newSize.x, newSize.y);
+    viewport.SetView(GetSize().x, GetSize().y);
+    viewport.Fit();
+    OnViewChanged(true);
 
     return true;
 }
 
 void DrawingArea::OnReset()
 {
-    bkp.clear();
+    rebuilder.Cancel();
+    isRebuilding = false;
+    simplifier.Begin();
+    history.Clear();
+    isStroke = false;
     path.clear();
-    shapes.clear();
+    branches.clear();
+    grid.clear();
+    regenerated = 0;
+    isCacheValid = false;
     Refresh();
 }
 
 void DrawingArea::OnUndo()
 {
-    if (!path.empty()) {
-        bkp.push_back(path.back());
-        path.pop_back();
-    }
-    OnUpdate();
+    CommitStroke();
+    Tree::Geometry geometry{std::move(arena), std::move(branches)};
+    auto change = history.Undo(path, generator, geometry, !isRebuilding);
+    arena = std::move(geometry.arena);
+    branches = std::move(geometry.branches);
+    OnHistory(change);
+    ResumeStroke();
     Refresh();
 }
 
 void DrawingArea::OnRedo()
 {
-    if (!bkp.empty()) {
-        path.push_back(bkp.back());
-        bkp.pop_back();
+    CommitStroke();
+    Tree::Geometry geometry{std::move(arena), std::move(branches)};
+    auto change = history.Redo(path, generator, geometry, !isRebuilding);
+    arena = std::move(geometry.arena);
+    branches = std::move(geometry.branches);
+    OnHistory(change);
+    ResumeStroke();
+    Refresh();
+}
+
+void DrawingArea::OnHistory(Tree::History::Change change)
+{
+    using Kind = Tree::History::Change::Kind;
+
+    // Branches out of date are made again with the next rebuild
+    if (change.kind == Kind::Restored) {
+        rebuilder.Cancel();
+        isRebuilding = false;
+        grid.build(branches);
+        regenerated = 0;
+        isCacheValid = false;
+    }
+    else if (change.kind == Kind::All || (change.kind != Kind::None && isRebuilding)) {
+        RequestUpdate();    // repeated undos are one rebuild
+    }
+    else if (change.kind == Kind::Removed && branches.size() > path.size()) {
+        Invalidate(branches.back().bounds);
+        grid.erase(branches.size() - 1, branches.back());
+        branches.pop_back();
+        regenerated = 0;
+    }
+    else if (change.kind == Kind::Added || change.kind == Kind::Path) {
+        OnUpdate(change.index);
     }
+}
+
+void DrawingArea::Reseed()
+{
+    // New random colours, the same ones after every rebuild
+    CommitStroke();
+    seed = std::random_device()();
+    history.Reseed(path, seed, !isRebuilding);
     OnUpdate();
     Refresh();
 }
 
 void DrawingArea::SetColor(unsigned int number, wxColour colorPen, wxColour colorBrush)
 {
+    CommitStroke();
+    auto before = generator;
     switch (number) {
     case 0:
-        colorShapePen = colorPen;
+        generator.colorShapePen = Tree::Colour(colorPen.Red(), colorPen.Green(), colorPen.Blue(), colorPen.Alpha());
         break;
     case 1:
-        colorShapeBrush = colorBrush;
-        randomColorShapeBrush = false;
+        generator.colorShapeBrush = Tree::Colour(colorBrush.Red(), colorBrush.Green(), colorBrush.Blue(), colorBrush.Alpha());
+        generator.randomColorShapeBrush = false;
         break;
     case 2:
-        colorLinePen = colorPen;
-        colorLineBrush = colorBrush;
+        generator.colorLinePen = Tree::Colour(colorPen.Red(), colorPen.Green(), colorPen.Blue(), colorPen.Alpha());
+        generator.colorLineBrush = Tree::Colour(colorBrush.Red(), colorBrush.Green(), colorBrush.Blue(), colorBrush.Alpha());
         break;
     default:
         break;
     }
+    history.SetGenerator(before, generator, !isRebuilding);
     OnUpdate();
     Refresh();
 }
@@ -276,9 +778,8 @@ void DrawingArea::SetShape(unsigned number, bool all)
 {
     shapeNumber = number;
     if (all) {
-        for (unsigned i = 0; i < path.size(); i++) {
-            path[i].shapeNumber = number;
-        }
+        CommitStroke();
+        history.Set(path, Tree::History::Field::Shape, Tree::History::AllPaths, number, !isRebuilding);
     }
     OnUpdate();
     Refresh();
@@ -289,257 +790,207 @@ bool DrawingArea::IsEmpty()
     return path.empty();
 }
 
+void DrawingArea::SetDetail(bool isEnabled)
+{
+    level.SetEnabled(isEnabled);
+    isCacheValid = false;
+    Refresh();
+}
+
 void DrawingArea::SetStyle(bool isSpline)
 {
-    this->isSpline = isSpline;
+    CommitStroke();
+    auto before = generator;
+    generator.isSpline = isSpline;
+    history.SetGenerator(before, generator, !isRebuilding);
     OnUpdate();
     Refresh();
 }
 
 void DrawingArea::SetValue(unsigned number, unsigned value, bool all)
 {
+    using Field = Tree::History::Field;
+
+    CommitStroke();
+    auto index = all ? Tree::History::AllPaths : path.size() - 1;
+    auto before = generator;
     switch (number) {
     case 0:
         shapeAngle = value < 0 ? 0 : value;
         shapeAngle = value > 180 ? 180 : value;
-        if (all) {
-            for (unsigned i = 0; i < path.size(); i++) {
-                path[i].shapeAngle = shapeAngle;
-            }
-        } else {
-            if (!path.empty()) {
-                path.back().shapeAngle = shapeAngle;
-            }
+        if (all || !path.empty()) {
+            history.Set(path, Field::Angle, index, shapeAngle, !isRebuilding);
         }
         break;
     case 1:
         shapeLenght = value < 0 ? 0 : value;
         shapeLenght = value > 150 ? 150 : value;
-        if (all) {
-            for (unsigned i = 0; i < path.size(); i++) {
-                path[i].shapeLenght = shapeLenght;
-            }
-        } else {
-            if (!path.empty()) {
-                path.back().shapeLenght = shapeLenght;
-            }
+        if (all || !path.empty()) {
+            history.Set(path, Field::Length, index, shapeLenght, !isRebuilding);
         }
         break;
     case 2:
         limitLength = value < 0 ? 0 : value;
         limitLength = value > 50 ? 50 : value;
-        if (all) {
-            for (unsigned i = 0; i < path.size(); i++) {
-                path[i].limitLength = limitLength;
-            }
-        } else {
-            if (!path.empty()) {
-                path.back().limitLength = limitLength;
-            }
+        if (all || !path.empty()) {
+            history.Set(path, Field::Limit, index, limitLength, !isRebuilding);
         }
         break;
     case 3:
-        lineWidth = value < 0 ? 0 : value;
-        lineWidth = value > 20 ? 20 : value;
+        generator.lineWidth = value < 0 ? 0 : value;
+        generator.lineWidth = value > 20 ? 20 : value;
+        history.SetGenerator(before, generator, !isRebuilding);
         break;
+    case 4:
+        simplifier.SetTolerance(std::min(value, 10u));
+        return;     // next samples only
     default:
         break;
     };
-    OnUpdate();
+    if (all || number == 3 || isRebuilding) {
+        RequestUpdate();    // slider events are coalesced
+    }
+    else {
+        OnUpdate(path.size() - 1);  // only the current branch has changed
+    }
     Refresh();
 }
 
 void DrawingArea::SetRandomColor(wxColour color1, wxColour color2)
 {
-    minColorShapeBrush = wxColour(std::min(color1.Red(), color2.Red()),
-                                  std::min(color1.Green(), color2.Green()),
-                                  std::min(color1.Blue(), color2.Blue()));
-    maxColorShapeBrush = wxColour(std::max(color1.Red(), color2.Red()),
-                                  std::max(color1.Green(), color2.Green()),
-                                  std::max(color1.Blue(), color2.Blue()));
-    randomColorShapeBrush = !(color1 == color2);
+    CommitStroke();
+    auto before = generator;
+    generator.minColorShapeBrush = Tree::Colour(std::min(color1.Red(), color2.Red()),
+                                                std::min(color1.Green(), color2.Green()),
+                                                std::min(color1.Blue(), color2.Blue()));
+    generator.maxColorShapeBrush = Tree::Colour(std::max(color1.Red(), color2.Red()),
+                                                std::max(color1.Green(), color2.Green()),
+                                                std::max(color1.Blue(), color2.Blue()));
+    generator.randomColorShapeBrush = !(color1 == color2);
+    history.SetGenerator(before, generator, !isRebuilding);
     OnUpdate();
     Refresh();
 }
 
+int DrawingArea::GetPathAt(wxPoint point)
+{
+    // Index of the path drawn under the point on screen, -1 if there is none
+    return grid.at(viewport.ToLogical(point.x, point.y), branches, generator.lineWidth);
+}
+
+wxSize DrawingArea::GetCanvasSize()
+{
+    return currentSize;
+}
+
+unsigned DrawingArea::GetRegenerated()
+{
+    // Shapes generated by the last update
+    return regenerated;
+}
+
 unsigned DrawingArea::GetValue(unsigned number)
 {
-    std::vector<unsigned> result{shapeAngle, shapeLenght, limitLength, lineWidth};
+    std::vector<unsigned> result{shapeAngle, shapeLenght, limitLength, generator.lineWidth,
+                                 static_cast<unsigned>(simplifier.Tolerance())};
     return number < result.size() ? result[number] : 0;
 }
 
 bool DrawingArea::OnSaveSvgDC(wxString path)
 {
+    FinishUpdate();
     wxSVGFileDC svgDC(path, currentSize.x, currentSize.y);
     OnDraw(svgDC);
 
     return svgDC.IsOk();
 }
 
-bool DrawingArea::OnSaveSvg(wxString path, SVG::Metadata metadata)
-{
-    int count = 0;
-    std::string image = "";
-    std::string group = "";
-    for (unsigned i = 0; i < shapes.size(); i++) {
-        Shape s = shapes[i];
-        SVG::Shape svgShape(std::string(s.name) + std::to_string(count++),
-                            SVG::RGB2HEX(s.brush.Red(), s.brush.Green(), s.brush.Blue()),
-                            SVG::RGB2HEX(s.pen.Red(), s.pen.Green(), s.pen.Blue()),
-                            s.lineWidth);
-        std::vector<SVG::Point> points;
-        for (auto &point : s.points) {
-            points.push_back(SVG::Point(point.x, point.y));
-        }
-        svgShape.points = points;
-        if (s.name == "Polygon" || s.name == "Spline") {
-            group += SVG::polygon(svgShape);
-            if (i == shapes.size() - 1) {
-                image = group;
-            }
-        }
-        else {
-            if (!group.empty()) {
-                group = SVG::group("Leafs" + std::to_string(count++), group);
-                image += SVG::group("Branch" + std::to_string(count++),
-                                    group + SVG::polyline(svgShape));
-                group = "";
-            }
-            else {
-                image += SVG::polyline(svgShape);
-            }
-        }
+bool DrawingArea::OnSaveSvg(wxString path, SVG::Metadata metadata, bool symbols)
+{
+    FinishUpdate();
+    if (isExporting) {
+        return false;   // one export at a time
+    }
+    if (exporter.joinable()) {
+        exporter.join();
     }
 
-    std::string svg = SVG::svg(currentSize.x, currentSize.y, image, metadata);
-    //wxMessageOutputDebug().Printf("%s", svg);
+    // The tree as it is now, drawing goes on while the pool writes it
+    auto snapshot = std::make_shared<std::vector<Tree::Branch>>(branches);
+    if (metadata.date.empty()) {
+        std::time_t t = std::time(nullptr);     // not thread-safe, set here
+        metadata.date = std::to_string(1900 + std::localtime(&t)->tm_year);
+    }
+    Tree::ExportOptions options;
+    options.symbols = symbols;
+    auto name = std::filesystem::path(std::string(path)).filename().string();
+    isExporting = true;
+    exporter = std::jthread([this, snapshot, generator = generator, size = currentSize, file = std::string(path),
+                             metadata, options, name](std::stop_token stop) {
+        SVG::FileSink sink(file);
+        unsigned percent = 0;
+        auto progress = [&](std::size_t done, std::size_t total) {
+            unsigned now = total > 0 ? 100 * done / total : 100;
+            if (now != percent) {
+                percent = now;
+                CallAfter([this, name, now]() { frame->SetStatusText(wxString::Format("Save: %s %u%%", name, now)); });
+            }
+        };
+        auto ok = Tree::ExportSvg(sink, generator, *snapshot, size.x, size.y, metadata, exportPool, options,
+                                  progress, stop);
+        ok = sink.close() && ok;
+        CallAfter([this, name, ok]() {
+            isExporting = false;
+            frame->SetStatusText(ok ? "Save: " + name : "There was something wrong!");
+        });
+    });
 
-    return SVG::save(svg, std::string(path));
+    return true;
 }
 
-bool DrawingArea::OnSaveTxT(wxString path)
+bool DrawingArea::OnSaveProject(wxString path)
 {
-    std::string delim = "\t";
-    std::string txt = "Drawing Area" + delim + std::to_string(currentSize.x) + " x " + std::to_string(currentSize.y) + "\n";
-    txt += "Name" + delim + "Stroke" + delim + "Fill" + delim + "Stroke width" + delim + "Points\n";
-    for (auto &shape : shapes) {
-        txt += std::string(shape.name) + delim;
-        txt += SVG::RGB2HEX(shape.pen.Red(), shape.pen.Green(), shape.pen.Blue()) + delim;
-        txt += SVG::RGB2HEX(shape.brush.Red(), shape.brush.Green(), shape.brush.Blue()) + delim;
-        txt += std::to_string(shape.lineWidth) + delim;
-        for (auto &point : shape.points) {
-            txt += std::to_string(point.x) + "," + std::to_string(point.y) + delim;
-        }
-        txt += "\n";
-    }
-    //wxMessageOutputDebug().Printf("%s", txt);
-
-    return SVG::save(txt, std::string(path));
+    FinishUpdate();
+    Tree::Drawing drawing;
+    drawing.width = currentSize.x;
+    drawing.height = currentSize.y;
+    drawing.generator = generator;
+    drawing.paths = this->path;
+    drawing.seed = seed;
+
+    return Tree::ProjectFile::Save(std::string(path), drawing);
 }
 
-std::vector<wxPoint> DrawingArea::GetPoints(unsigned shape, wxPoint pos, unsigned lenght, unsigned angle)
+bool DrawingArea::OnOpenProject(wxString path)
 {
-    // Custom images similar to leaf buttons
-    std::vector<wxPoint> points;
-    if (shape == 2) {
-        points = {pos,
-            pos + angularCoordinate(lenght / 2, angle + 15),
-            pos + angularCoordinate(lenght, angle),
-            pos + angularCoordinate(lenght / 2, angle - 15),
-            pos
-        };
-    }
-    else if (shape == 3) {
-        points = {pos,
-            pos + angularCoordinate(lenght * 2 / 5, angle + 45),
-            pos + angularCoordinate(lenght, angle),
-            pos + angularCoordinate(lenght * 2 / 5, angle - 45),
-            pos
-        };
-    }
-    else if (shape == 4) {
-        points = {pos,
-            pos + angularCoordinate(lenght * 2 / 6, angle + 60),
-            pos + angularCoordinate(lenght * 4 / 6, angle + 20),
-            pos + angularCoordinate(lenght, angle),
-            pos + angularCoordinate(lenght * 4 / 6, angle - 20),
-            pos + angularCoordinate(lenght * 2 / 6, angle - 60),
-            pos
-        };
-    }
-    else if (shape == 5) {
-        points = {pos,
-            pos + angularCoordinate(lenght, angle + 15),
-            pos + angularCoordinate(lenght * 3 / 5, angle),
-            pos + angularCoordinate(lenght, angle - 15),
-            pos
-        };
-    }
-    else if (shape == 6) {
-        points = {pos,
-            pos + angularCoordinate(lenght, angle + 20),
-            pos + angularCoordinate(lenght * 1 / 5, angle),
-            pos + angularCoordinate(lenght, angle + 15),
-            pos + angularCoordinate(lenght * 2 / 5, angle),
-            pos + angularCoordinate(lenght, angle + 5),
-            pos + angularCoordinate(lenght * 3 / 5, angle),
-            pos + angularCoordinate(lenght, angle - 5),
-            pos + angularCoordinate(lenght * 2 / 5, angle),
-            pos + angularCoordinate(lenght, angle - 15),
-            pos + angularCoordinate(lenght * 1 / 5, angle),
-            pos + angularCoordinate(lenght, angle - 20),
-            pos
-        };
-    }
-    else if (shape == 7) {
-        points = {pos,
-            pos + angularCoordinate(lenght, angle + 45),
-            pos + angularCoordinate(lenght * 2 / 6, angle),
-            pos + angularCoordinate(lenght, angle + 30),
-            pos + angularCoordinate(lenght * 3 / 6, angle),
-            pos + angularCoordinate(lenght, angle + 10),
-            pos + angularCoordinate(lenght * 4 / 6, angle),
-            pos + angularCoordinate(lenght, angle - 10),
-            pos + angularCoordinate(lenght * 3 / 6, angle),
-            pos + angularCoordinate(lenght, angle - 30),
-            pos + angularCoordinate(lenght * 2 / 6, angle),
-            pos + angularCoordinate(lenght, angle - 45),
-            pos
-        };
-    }
-    else if (shape == 8) {
-        points = {pos,
-            pos + angularCoordinate(lenght / 2, angle + 70),
-            pos + angularCoordinate(lenght / 2, angle + 50),
-            pos + angularCoordinate(lenght / 2, angle + 10),
-            pos + angularCoordinate(lenght / 2, angle - 10),
-            pos + angularCoordinate(lenght / 2, angle - 50),
-            pos + angularCoordinate(lenght / 2, angle - 70),
-            pos
-        };
-    }
-    else if (shape == 9) {
-        points = {pos,
-            pos + angularCoordinate(lenght, angle + 20),
-            pos + angularCoordinate(lenght, angle + 5),
-            pos + angularCoordinate(lenght, angle - 20),
-            pos
-        };
+    Tree::Drawing drawing;
+    if (!Tree::ReadProject(std::string(path), drawing)) {
+        return false;
     }
-    else if (shape == 10) {
-        points = {pos,
-            pos + angularCoordinate(lenght, angle + 60),
-            pos + angularCoordinate(lenght * 2 / 5, angle - 45),
-            pos,
-            pos + angularCoordinate(lenght * 2 / 5, angle + 45),
-            pos + angularCoordinate(lenght, angle - 60),
-            pos
-        };
-    }
-    else {
-        // Simple line
-        points = {pos, pos + angularCoordinate(lenght, angle)};
+    if (wxSize(drawing.width, drawing.height) != currentSize && !Resize(wxSize(drawing.width, drawing.height))) {
+        return false;   // larger than MaxCanvas
     }
 
-    return points;
+    OnReset();
+    generator = drawing.generator;
+    this->path = std::move(drawing.paths);
+    seed = drawing.seed;
+    breakPath = true;
+    isDrawing = false;
+    OnUpdate();
+    Refresh();
+
+    return true;
+}
+
+bool DrawingArea::OnSaveTxT(wxString path)
+{
+    FinishUpdate();
+    std::string txt = generator.Txt(branches, currentSize.x, currentSize.y);
+    //wxMessageOutputDebug().Printf("%s", txt);
+
+    Tree::Profiler::Scope scope(Tree::Profiler::Phase::Save);
+    Tree::Profiler::Add(Tree::Profiler::Counter::Bytes, txt.size());
+
+    return SVG::save(txt, std::string(path));
 }
@@ -6,93 +6,153 @@
 #include <wx/wx.h>
 #endif
 
-#include "svg.h"    // custom generator
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <unordered_map>
+
+#include "svg.h"     // custom generator
+#include "tree.h"    // leafs and branches
+#include "spatialGrid.h"
+#include "threadPool.h"
+#include "detail.h"
+#include "history.h"
+#include "profiler.h"
+#include "rebuilder.h"
+#include "stroke.h"
+#include "viewport.h"
 
 class DrawingArea : public wxPanel {
 public:
+    static constexpr int MaxCanvas = 20000;     // logical pixels of each side
+    static constexpr std::size_t UndoBudget = 64 << 20;     // bytes of the undo history
+
     DrawingArea(wxFrame *parent, int id, wxPoint position, wxSize size);
 
     bool IsEmpty();
-    bool OnSaveSvg(wxString path, SVG::Metadata metadata);
+    bool OnOpenProject(wxString path);
+    bool OnSaveProject(wxString path);
+    bool OnSaveSvg(wxString path, SVG::Metadata metadata, bool symbols = false);
     bool OnSaveSvgDC(wxString path);
     bool OnSaveTxT(wxString path);
     bool Resize(wxSize size, bool reset = true);
 
+    int GetPathAt(wxPoint point);
+    wxSize GetCanvasSize();
+    unsigned GetRegenerated();
     unsigned GetValue(unsigned number);
 
     void BreakPath();
     void OnMouseClicked(wxMouseEvent &event);
+    void OnMouseView(wxMouseEvent &event);
     void OnRedo();
     void OnReset();
     void OnUndo();
+    void Reseed();
     void SetColor(unsigned number, wxColour colorPen, wxColour colorBrush);
+    void SetDetail(bool isEnabled);
     void SetRandomColor(wxColour color1 = wxColour(0, 0, 0, 255), wxColour color2 = wxColour(0, 0, 0, 255));
     void SetShape(unsigned number, bool all = false);
     void SetStyle(bool isSpline = false);
     void SetValue(unsigned number, unsigned value, bool all = false);
+    void Zoom(double factor);
+    void ZoomFit();
 
 private:
     // Cursor
     wxColour colorBorderPen, colorBorderBrush;
     wxColour colorCursorPen, colorCursorBrush;
-    wxColour colorLinePen, colorLineBrush;
-    wxColour colorShapePen, colorShapeBrush;
-    wxColour minColorShapeBrush, maxColorShapeBrush;
     wxPoint cursorPosition;
+    wxRect cursorArea;  // last painted
 
     unsigned cursorRadius;
 
-    bool randomColorShapeBrush;
-
     // Status
+    wxFrame *frame;     // status bar
     bool isDrawing;
-    wxSize maxSize;
-    wxSize currentSize;
+    int hoveredPath;    // shown in the status bar, -1 for none
+    wxSize maxSize;     // of the panel, the screen
+    wxSize currentSize; // of the canvas
 
-    // Draw
-    struct Shape {
-        wxString name = "";
-        wxColour pen = wxColour(0, 0, 0, 255);
-        wxColour brush = wxColour(255, 255, 255, 255);
-        unsigned lineWidth = 1;
-        std::vector<wxPoint> points;
-
-        Shape() {}
-        Shape(wxString name, wxColour pen, wxColour brush, unsigned lineWidth,
-              std::vector<wxPoint> points)
-            : name(name), pen(pen), brush(brush), lineWidth(lineWidth), points(points) {}
-    };
+    // View of the canvas, panned by the middle button and zoomed by the wheel
+    Tree::Viewport viewport;
+    wxPoint panPosition;
+    bool isPanning;
 
-    struct Path {
-        unsigned limitLength;
-        unsigned shapeAngle;
-        unsigned shapeLenght;
-        unsigned shapeNumber;
-        std::vector<wxPoint> points;
-
-        Path(wxPoint point)
-            : points({point}), limitLength(0), shapeAngle(0), shapeLenght(0), shapeNumber(0) {}
-        Path(wxPoint point, unsigned shapeNumber, unsigned shapeAngle = 0, unsigned shapeLenght = 0, unsigned limitLength = 0)
-            : points({point}), shapeAngle(shapeAngle), shapeLenght(shapeLenght), shapeNumber(shapeNumber), limitLength(limitLength) {}
+    // Draw
+    Tree::Generator generator;
+    Tree::ThreadPool pool;  // full rebuilds on the UI thread
+    Tree::ArenaPool arenas; // their geometry
+    // Background rebuilds, with their own workers: a rebuild waits for every task of its pool
+    Tree::ThreadPool rebuildPool;
+    Tree::Rebuilder rebuilder;
+    bool isRebuilding;
+
+    // SVG export off the UI thread, stopped and joined first on destruction, with its own workers as well
+    Tree::ThreadPool exportPool;
+    std::jthread exporter;
+    std::atomic<bool> isExporting;
+
+    Tree::StrokeSimplifier simplifier;  // mouse samples of the current path
+
+    // Edits as they are made, a stroke once it is done
+    Tree::History history;
+    std::size_t strokeStart;    // points of the path before the stroke, 0 for a new path
+    bool isStroke;
+
+    std::vector<Tree::Path> path;
+    std::shared_ptr<Tree::Arena> arena;     // of the last full rebuild, outlives the branches
+    std::vector<Tree::Branch> branches;
+    std::vector<wxPoint> buffer;
+
+    // Shapes by position, kept up to date with the branches
+    Tree::SpatialGrid grid;
+    std::vector<Tree::SpatialGrid::Entry> visible;
+
+    // Committed tree in tiles of the zoomed canvas, painted again only when the branches change
+    struct Tile {
+        wxBitmap bitmap;
+        Tree::Box dirty;    // logical area to be drawn again
+        int column = 0;
+        int row = 0;
+        bool isValid = false;
+        std::uint64_t used = 0;
     };
+    static constexpr std::size_t MaxTiles = 192;
+    std::unordered_map<std::uint64_t, Tile> tiles;
+    std::uint64_t frameNumber;
+    Tree::Box cacheDirty;   // logical area changed since the last paint
+    bool isCacheGrid;
+    bool isCacheValid;
+    Tree::DetailLevel level;    // of the leafs on screen
 
-    std::vector<Path> bkp;
-    std::vector<Path> path;
-    std::vector<Shape> shapes;
-
-    bool isSpline;
     bool breakPath;
 
     unsigned limitLength;
-    unsigned lineWidth;
     unsigned panelBorder;
+    unsigned regenerated;
+    unsigned seed;
     unsigned shapeAngle;
     unsigned shapeLenght;
     unsigned shapeNumber;
 
+    Tree::Box GetCursorArea();
+    Tile &GetTile(int column, int row);
+    wxRect ToScreen(const Tree::Box &box);
+    void Invalidate(const Tree::Box &box);
     void OnDraw(wxDC &dc);
+    void OnDrawCursor(wxDC &dc);
+    void OnDrawTree(wxDC &dc, bool isScreen = true);
     void OnPaint(wxPaintEvent &event);
+    void OnPaint(wxDC &dc);
+    void OnRebuilt(std::shared_ptr<Tree::Rebuilder::Result> result);
+    void OnViewChanged(bool isZoomed);
     void OnUpdate();
-
-    std::vector<wxPoint> GetPoints(unsigned shape, wxPoint pos, unsigned lenght, unsigned angle);
+    void OnUpdate(unsigned index, bool incremental = false);
+    void CommitStroke();
+    void FinishStroke();
+    void ResumeStroke();
+    void OnHistory(Tree::History::Change change);
+    void FinishUpdate();
+    void RequestUpdate();
 };
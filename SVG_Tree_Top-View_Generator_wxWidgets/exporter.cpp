@@ -0,0 +1,137 @@
+#include "exporter.h"
+
+#include <condition_variable>
+#include <mutex>
+
+#include "profiler.h"
+
+namespace Tree {
+
+namespace {
+
+// Branches [begin, end) and the name number of their first shape.
+struct Chunk {
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    unsigned number = 0;
+    std::size_t shapes = 0;
+};
+
+// Tasks of a window still running. Lives for the whole export and is reset between windows: a task is done
+// with it before the waiting thread can return.
+class Countdown {
+public:
+    void Reset(std::size_t count)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        remaining = count;
+    }
+
+    void CountDown()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--remaining == 0) {
+            done.notify_all();
+        }
+    }
+
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return remaining == 0; });
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable done;
+    std::size_t remaining = 0;
+};
+
+} // namespace
+
+auto ExportSvg(SVG::Sink &sink, const Generator &generator, const std::vector<Branch> &branches, int width,
+               int height, const SVG::Metadata &metadata, ThreadPool &pool, const ExportOptions &options,
+               const ExportProgress &progress, std::stop_token stop) -> bool
+{
+    Profiler::Scope scope(Profiler::Phase::Export);
+    auto bytes = sink.bytes();
+
+    // Chunks, numbered as the serial export would
+    std::vector<Chunk> chunks;
+    std::size_t total = 0;
+    unsigned number = 0;
+    for (std::size_t b = 0; b < branches.size(); b++) {
+        if (chunks.empty() || chunks.back().shapes >= options.chunkShapes) {
+            chunks.push_back({b, b, number, 0});
+        }
+        auto names = generator.SvgNames(branches[b]);
+        chunks.back().end = b + 1;
+        chunks.back().shapes += names;
+        number += names;
+        total += names;
+    }
+
+    // Header and definitions on this thread
+    SVG::Writer writer(sink, options.precision);
+    writer.header(width, height, metadata);
+    SvgClasses classes;
+    if (options.symbols) {
+        classes = generator.SvgDefs(writer, branches);
+    }
+    auto *used = options.symbols ? &classes : nullptr;
+
+    // Two windows of buffers, one written while the other is serialized
+    std::size_t window = 2 * std::max(pool.Size(), 1u);
+    std::vector<std::string> buffers(2 * window);
+    Countdown ready[2];
+    auto serialize = [&](std::size_t first) {
+        auto slot = (first / window) % 2;
+        auto last = std::min(first + window, chunks.size());
+        ready[slot].Reset(last - first);
+        for (auto c = first; c < last; c++) {
+            pool.Push([&, c, slot]() {
+                auto &buffer = buffers[slot * window + c % window];
+                buffer.clear();
+                if (!stop.stop_requested()) {
+                    SVG::MemorySink memory(buffer);
+                    SVG::Writer part(memory, options.precision);
+                    generator.SvgBranches(part, branches, chunks[c].begin, chunks[c].end, chunks[c].number, used);
+                }
+                ready[slot].CountDown();
+            });
+        }
+    };
+
+    std::size_t done = 0;
+    if (!chunks.empty()) {
+        serialize(0);
+    }
+    for (std::size_t first = 0; first < chunks.size(); first += window) {
+        auto slot = (first / window) % 2;
+        auto last = std::min(first + window, chunks.size());
+        if (last < chunks.size()) {
+            serialize(last);
+        }
+        ready[slot].Wait();
+        if (stop.stop_requested()) {
+            // The tasks of the next window still use the buffers
+            if (last < chunks.size()) {
+                ready[1 - slot].Wait();
+            }
+            return false;
+        }
+        sink.put(std::span<const std::string>(buffers.data() + slot * window, last - first));
+        for (auto c = first; c < last; c++) {
+            done += chunks[c].shapes;
+        }
+        if (progress) {
+            progress(done, total);
+        }
+    }
+    writer.footer();
+    Profiler::Add(Profiler::Counter::Bytes, sink.bytes() - bytes);
+
+    return sink.ok();
+}
+
+} // namespace Tree
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <functional>
+#include <stop_token>
+#include <vector>
+
+#include "tree.h"
+#include "threadPool.h"
+
+/*
+ * SVG export on a thread pool, with the same bytes as Generator::Svg and Generator::SvgSymbols.
+ *
+ * The branches are cut in chunks of about chunkShapes shapes, each one serialized by the pool into its own buffer.
+ * Chunks go in windows of two per worker: while a window is written in order with one vectored write,
+ * the pool already serializes the next one. At most two windows are kept in memory.
+ */
+namespace Tree {
+
+struct ExportOptions {
+    SVG::Precision precision = SVG::Precision::Full;
+    bool symbols = false;               // see Generator::SvgSymbols
+    std::size_t chunkShapes = 8192;
+};
+
+// Shapes written and shapes of the drawing, called from the exporting thread.
+using ExportProgress = std::function<void(std::size_t done, std::size_t total)>;
+
+// Returns false if the sink failed or the export was stopped. Not to be called from a task of the same pool.
+auto ExportSvg(SVG::Sink &sink, const Generator &generator, const std::vector<Branch> &branches, int width,
+               int height, const SVG::Metadata &metadata, ThreadPool &pool, const ExportOptions &options = {},
+               const ExportProgress &progress = {}, std::stop_token stop = {}) -> bool;
+
+} // namespace Tree
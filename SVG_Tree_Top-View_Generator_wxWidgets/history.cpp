@@ -0,0 +1,306 @@
+#include "history.h"
+
+#include <algorithm>
+
+namespace Tree {
+
+static auto Value(Path &path, History::Field field) -> unsigned &
+{
+    switch (field) {
+    case History::Field::Angle:
+        return path.shapeAngle;
+    case History::Field::Length:
+        return path.shapeLenght;
+    case History::Field::Limit:
+        return path.limitLength;
+    case History::Field::Shape:
+        return path.shapeNumber;
+    default:
+        return path.seed;
+    }
+}
+
+static auto IsEmpty(const Geometry &geometry) -> bool
+{
+    return !geometry.arena && geometry.branches.empty();
+}
+
+// The branches go before their arena.
+static void Drop(Geometry &geometry)
+{
+    auto dropped = std::move(geometry);
+    geometry = {};
+}
+
+// One bit for each global parameter that differs.
+static auto Changed(const Generator &a, const Generator &b) -> unsigned
+{
+    return (a.colorLineBrush != b.colorLineBrush) << 0 | (a.colorLinePen != b.colorLinePen) << 1 |
+           (a.colorShapeBrush != b.colorShapeBrush) << 2 | (a.colorShapePen != b.colorShapePen) << 3 |
+           (a.minColorShapeBrush != b.minColorShapeBrush) << 4 | (a.maxColorShapeBrush != b.maxColorShapeBrush) << 5 |
+           (a.randomColorShapeBrush != b.randomColorShapeBrush) << 6 | (a.isSpline != b.isSpline) << 7 |
+           (a.lineWidth != b.lineWidth) << 8;
+}
+
+void History::SetBudget(std::size_t value)
+{
+    budget = value;
+    Trim();
+}
+
+void History::Clear()
+{
+    entries.clear();
+    position = 0;
+    bytes = 0;
+    waiting = 0;
+    isOpen = false;
+}
+
+void History::Stroke(const std::vector<Path> &paths, std::size_t index, std::size_t from)
+{
+    if (index >= paths.size()) {
+        return;
+    }
+
+    auto &points = paths[index].points;
+    Entry entry;
+    if (from == 0) {
+        entry.command = AddPath{paths[index]};
+    }
+    else if (from < points.size()) {
+        entry.command = ExtendPath{index, from, std::vector<Point>(points.begin() + from, points.end())};
+    }
+    else {
+        return;     // nothing drawn
+    }
+    Push(std::move(entry));
+    isOpen = false;
+}
+
+void History::Set(std::vector<Path> &paths, Field field, std::size_t index, unsigned value, bool isSynced)
+{
+    if (index != AllPaths && index >= paths.size()) {
+        return;
+    }
+
+    auto first = index == AllPaths ? 0 : index;
+    auto last = index == AllPaths ? paths.size() : index + 1;
+    if (std::all_of(paths.begin() + first, paths.begin() + last, [&](Path & path) { return Value(path, field) == value; })) {
+        return;
+    }
+
+    // A dragged slider: the values before the first move are kept
+    auto *set = isOpen && !entries.empty() ? std::get_if<SetField>(&entries.back().command) : nullptr;
+    if (set && set->field == field && set->index == index && set->before.size() == last - first) {
+        set->after = {value};
+    }
+    else {
+        SetField command{field, index, {}, {value}};
+        for (auto i = first; i < last; i++) {
+            command.before.push_back(Value(paths[i], field));
+        }
+        Push(Entry{0, std::move(command), {}}, isSynced && index == AllPaths);
+    }
+    for (auto i = first; i < last; i++) {
+        Value(paths[i], field) = value;
+    }
+}
+
+void History::Reseed(std::vector<Path> &paths, unsigned seed, bool isSynced)
+{
+    SetField command{Field::Seed, AllPaths, {}, {}};
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        command.before.push_back(paths[i].seed);
+        paths[i].seed = static_cast<unsigned>(Random(seed, i));
+        command.after.push_back(paths[i].seed);
+    }
+    Push(Entry{0, std::move(command), {}}, isSynced);
+    isOpen = false;
+}
+
+void History::SetGenerator(const Generator &before, const Generator &after, bool isSynced)
+{
+    auto changed = Changed(before, after);
+    if (changed == 0) {
+        return;
+    }
+
+    // Same parameters again: the checkpoint is still the geometry before the first change
+    auto *set = isOpen && !entries.empty() ? std::get_if<SetParameters>(&entries.back().command) : nullptr;
+    if (set && Changed(set->before, set->after) == changed) {
+        set->after = after;
+        return;
+    }
+
+    Push(Entry{0, SetParameters{before, after}, {}}, isSynced);
+}
+
+void History::Keep(Geometry geometry)
+{
+    auto id = waiting;
+    waiting = 0;
+    auto entry = std::find_if(entries.begin(), entries.end(), [&](const Entry & item) { return item.id == id; });
+    if (id == 0 || entry == entries.end() || !IsEmpty(entry->checkpoint)) {
+        return;
+    }
+
+    bytes -= entry->bytes;
+    entry->checkpoint = std::move(geometry);
+    entry->bytes = Bytes(*entry);
+    bytes += entry->bytes;
+    Trim();
+}
+
+auto History::Undo(std::vector<Path> &paths, Generator &generator, Geometry &geometry, bool isSynced) -> Change
+{
+    waiting = 0;
+    isOpen = false;
+    if (!CanUndo()) {
+        return {};
+    }
+
+    position--;
+    return Apply(entries[position], true, paths, generator, geometry, isSynced);
+}
+
+auto History::Redo(std::vector<Path> &paths, Generator &generator, Geometry &geometry, bool isSynced) -> Change
+{
+    waiting = 0;
+    isOpen = false;
+    if (!CanRedo()) {
+        return {};
+    }
+
+    position++;
+    return Apply(entries[position - 1], false, paths, generator, geometry, isSynced);
+}
+
+void History::Push(Entry entry, bool isSynced)
+{
+    // A new edit drops the undone ones
+    while (entries.size() > position) {
+        bytes -= entries.back().bytes;
+        entries.pop_back();
+    }
+    entry.id = ++lastId;
+    entry.bytes = Bytes(entry);
+    bytes += entry.bytes;
+    entries.push_back(std::move(entry));
+    position = entries.size();
+    waiting = isSynced ? lastId : 0;
+    isOpen = true;
+    Trim();
+}
+
+auto History::Apply(Entry &entry, bool isUndo, std::vector<Path> &paths, Generator &generator, Geometry &geometry,
+                    bool isSynced) -> Change
+{
+    using Kind = Change::Kind;
+
+    if (auto *add = std::get_if<AddPath>(&entry.command)) {
+        if (isUndo) {
+            paths.pop_back();
+            return {Kind::Removed, paths.size()};
+        }
+        paths.push_back(add->path);
+        return {Kind::Added, paths.size() - 1};
+    }
+
+    if (auto *extend = std::get_if<ExtendPath>(&entry.command)) {
+        auto &points = paths[extend->index].points;
+        if (isUndo) {
+            points.resize(extend->from);
+        }
+        else {
+            points.insert(points.end(), extend->points.begin(), extend->points.end());
+        }
+        return {Kind::Path, extend->index};
+    }
+
+    if (auto *set = std::get_if<SetField>(&entry.command)) {
+        auto first = set->index == AllPaths ? 0 : set->index;
+        auto &values = isUndo ? set->before : set->after;
+        for (std::size_t i = 0; i < set->before.size(); i++) {
+            Value(paths[first + i], set->field) = values[std::min(i, values.size() - 1)];
+        }
+        if (set->index != AllPaths) {
+            return {Kind::Path, set->index};
+        }
+    }
+    else if (auto *parameters = std::get_if<SetParameters>(&entry.command)) {
+        generator = isUndo ? parameters->before : parameters->after;
+    }
+
+    // Full rebuild, unless the checkpoint is the geometry of the other side
+    bytes -= entry.bytes;
+    Change change{Kind::All, 0};
+    if (!IsEmpty(entry.checkpoint)) {
+        std::swap(geometry, entry.checkpoint);
+        if (!isSynced) {
+            Drop(entry.checkpoint);
+        }
+        change.kind = Kind::Restored;
+    }
+    else if (isSynced) {
+        waiting = entry.id;     // the current geometry, once rebuilt
+    }
+    entry.bytes = Bytes(entry);
+    bytes += entry.bytes;
+    Trim();
+
+    return change;
+}
+
+void History::Trim()
+{
+    // Checkpoints are only a cache: the oldest ones go first, then the oldest edits
+    for (auto &entry : entries) {
+        if (bytes <= budget) {
+            return;
+        }
+        if (!IsEmpty(entry.checkpoint)) {
+            bytes -= entry.bytes;
+            Drop(entry.checkpoint);
+            entry.bytes = Bytes(entry);
+            bytes += entry.bytes;
+        }
+    }
+    while (bytes > budget && position > 0 && entries.size() > 1) {
+        bytes -= entries.front().bytes;
+        entries.pop_front();
+        position--;
+    }
+}
+
+auto History::Bytes(const Entry &entry) -> std::size_t
+{
+    auto size = sizeof(Entry) + Bytes(entry.checkpoint);
+    if (auto *add = std::get_if<AddPath>(&entry.command)) {
+        size += add->path.points.capacity() * sizeof(Point);
+    }
+    else if (auto *extend = std::get_if<ExtendPath>(&entry.command)) {
+        size += extend->points.capacity() * sizeof(Point);
+    }
+    else if (auto *set = std::get_if<SetField>(&entry.command)) {
+        size += (set->before.capacity() + set->after.capacity()) * sizeof(unsigned);
+    }
+
+    return size;
+}
+
+auto History::Bytes(const Geometry &geometry) -> std::size_t
+{
+    auto size = geometry.branches.capacity() * sizeof(Branch);
+    if (geometry.arena) {
+        return size + std::max(geometry.arena->Capacity(), geometry.arena->Used());
+    }
+    for (auto &branch : geometry.branches) {
+        size += branch.leafs.memory() + branch.placements.capacity() * sizeof(Placement) +
+                branch.line.points.capacity() * sizeof(Point);
+    }
+
+    return size;
+}
+
+} // namespace Tree
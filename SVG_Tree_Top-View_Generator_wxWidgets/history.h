@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <variant>
+#include <vector>
+
+#include "arena.h"
+#include "tree.h"
+
+/*
+ * Undo and redo as a log of the edits of a drawing.
+ *
+ * Each edit is kept as its delta: a new path, the points added to one, the old and new values of a path field,
+ * or the old and new global parameters. Undo and redo apply the delta to the paths and the generator and tell
+ * which branches have to be generated again. Edits of the same kind in a row, as a dragged slider, are one entry.
+ *
+ * The edits of a global parameter need a full rebuild. Their entry keeps as a checkpoint the geometry of the
+ * other side of the edit, the one replaced when it was made or undone, and undo or redo swap it back instead.
+ * The log stays within a budget of bytes: the oldest checkpoints are dropped first, then the oldest entries.
+ */
+namespace Tree {
+
+// Branches of every path and the arena holding them, if any.
+struct Geometry {
+    std::shared_ptr<Arena> arena;
+    std::vector<Branch> branches;   // destroyed before their arena
+};
+
+class History {
+public:
+    enum class Field : unsigned char { Angle, Length, Limit, Shape, Seed };
+
+    static constexpr std::size_t AllPaths = SIZE_MAX;
+
+    // What an undo or redo changed.
+    struct Change {
+        enum class Kind : unsigned char {
+            None,
+            Added,      // the last path, its branch to be generated
+            Removed,    // the last path, its branch to be dropped
+            Path,       // the branch of one path to be generated again
+            All,        // every branch to be generated again
+            Restored,   // every branch, the given geometry was swapped with the checkpoint
+        };
+
+        Kind kind = Kind::None;
+        std::size_t index = 0;  // of the path
+    };
+
+    explicit History(std::size_t budget = 64 << 20) : budget(budget) {}
+
+    [[nodiscard]] auto Budget() const -> std::size_t { return budget; }
+    void SetBudget(std::size_t value);
+
+    [[nodiscard]] auto CanUndo() const -> bool { return position > 0; }
+    [[nodiscard]] auto CanRedo() const -> bool { return position < entries.size(); }
+
+    // Entries and bytes in use, checkpoints included.
+    [[nodiscard]] auto Size() const -> std::size_t { return entries.size(); }
+    [[nodiscard]] auto Bytes() const -> std::size_t { return bytes; }
+
+    void Clear();
+
+    // Records the stroke drawn on paths[index] since it had "from" points, a new path if from is 0.
+    void Stroke(const std::vector<Path> &paths, std::size_t index, std::size_t from);
+
+    // The edits of every branch take isSynced: true if the current geometry matches the paths, it is then
+    // expected by Keep() once replaced.
+
+    // Sets a field of one path or AllPaths and records it.
+    void Set(std::vector<Path> &paths, Field field, std::size_t index, unsigned value, bool isSynced = false);
+    // Sets the seed of each path from its index (see Random) and records it.
+    void Reseed(std::vector<Path> &paths, unsigned seed, bool isSynced = false);
+    // Records a change of the global parameters, made after this call.
+    void SetGenerator(const Generator &before, const Generator &after, bool isSynced = false);
+
+    // Geometry replaced by a full rebuild. Kept if an entry is waiting for it, else dropped.
+    void Keep(Geometry geometry);
+
+    // Geometry: the current one, swapped with the checkpoint if there is one. Not kept unless synced.
+    auto Undo(std::vector<Path> &paths, Generator &generator, Geometry &geometry, bool isSynced) -> Change;
+    auto Redo(std::vector<Path> &paths, Generator &generator, Geometry &geometry, bool isSynced) -> Change;
+
+private:
+    struct AddPath {
+        Path path;
+    };
+    struct ExtendPath {
+        std::size_t index = 0;
+        std::size_t from = 0;
+        std::vector<Point> points;
+    };
+    struct SetField {
+        Field field = Field::Angle;
+        std::size_t index = 0;
+        std::vector<unsigned> before;   // of each path
+        std::vector<unsigned> after;    // of each path, or one for all
+    };
+    struct SetParameters {
+        Generator before;
+        Generator after;
+    };
+
+    struct Entry {
+        std::uint64_t id = 0;
+        std::variant<AddPath, ExtendPath, SetField, SetParameters> command;
+        Geometry checkpoint;
+        std::size_t bytes = 0;  // command and checkpoint
+    };
+
+    std::size_t budget;
+    std::size_t bytes = 0;
+    std::deque<Entry> entries;
+    std::size_t position = 0;   // entries before it are applied
+    std::uint64_t lastId = 0;
+    std::uint64_t waiting = 0;  // entry for the next geometry given to Keep()
+    bool isOpen = false;        // the last entry may take the next edit of its kind
+
+    void Push(Entry entry, bool isSynced = false);
+    auto Apply(Entry &entry, bool isUndo, std::vector<Path> &paths, Generator &generator, Geometry &geometry,
+               bool isSynced) -> Change;
+    void Trim();
+
+    static auto Bytes(const Entry &entry) -> std::size_t;
+    static auto Bytes(const Geometry &geometry) -> std::size_t;
+};
+
+} // namespace Tree
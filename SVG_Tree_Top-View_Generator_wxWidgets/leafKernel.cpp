@@ -0,0 +1,180 @@
+#include "leafKernel.h"
+
+// Built with -ffp-contract=off: every kernel rounds each product and sum the same way.
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TREE_KERNEL_SSE2
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define TREE_KERNEL_AVX2
+#endif
+#endif
+
+namespace Tree {
+
+static void Scalar(const LeafTemplate &leaf, const LeafBatch &batch, Point *points)
+{
+    const auto size = leaf.size();
+    const double *unitX = leaf.UnitX();
+    const double *unitY = leaf.UnitY();
+    for (std::size_t i = 0; i < batch.size(); i++) {
+        // Rotation scaled by the leaf length
+        const double c = batch.lenght[i] * CosTable[DegreeIndex(batch.angle[i])];
+        const double s = batch.lenght[i] * SinTable[DegreeIndex(batch.angle[i])];
+        Point *point = points + i * size;
+        for (std::size_t k = 0; k < size; k++) {
+            point[k].x = batch.x[i] + static_cast<int>(c * unitX[k] - s * unitY[k]);
+            point[k].y = batch.y[i] + static_cast<int>(s * unitX[k] + c * unitY[k]);
+        }
+    }
+}
+
+#ifdef TREE_KERNEL_SSE2
+// Two vertices at a time, x and y are interleaved as Points.
+static void SSE2(const LeafTemplate &leaf, const LeafBatch &batch, Point *points)
+{
+    static_assert(sizeof(Point) == 2 * sizeof(int));
+    const auto size = leaf.size();
+    const auto last = size - size % 2;
+    const double *unitX = leaf.UnitX();
+    const double *unitY = leaf.UnitY();
+
+    for (std::size_t i = 0; i < batch.size(); i++) {
+        const double cos = batch.lenght[i] * CosTable[DegreeIndex(batch.angle[i])];
+        const double sin = batch.lenght[i] * SinTable[DegreeIndex(batch.angle[i])];
+        const __m128d c = _mm_set1_pd(cos);
+        const __m128d s = _mm_set1_pd(sin);
+        const __m128i x = _mm_set1_epi32(batch.x[i]);
+        const __m128i y = _mm_set1_epi32(batch.y[i]);
+        Point *point = points + i * size;
+        std::size_t k = 0;
+        for (; k < last; k += 2) {
+            const __m128d ux = _mm_loadu_pd(unitX + k);
+            const __m128d uy = _mm_loadu_pd(unitY + k);
+            const __m128i px = _mm_add_epi32(x, _mm_cvttpd_epi32(_mm_sub_pd(_mm_mul_pd(c, ux), _mm_mul_pd(s, uy))));
+            const __m128i py = _mm_add_epi32(y, _mm_cvttpd_epi32(_mm_add_pd(_mm_mul_pd(s, ux), _mm_mul_pd(c, uy))));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(point + k), _mm_unpacklo_epi32(px, py));
+        }
+        for (; k < size; k++) {
+            point[k].x = batch.x[i] + static_cast<int>(cos * unitX[k] - sin * unitY[k]);
+            point[k].y = batch.y[i] + static_cast<int>(sin * unitX[k] + cos * unitY[k]);
+        }
+    }
+}
+#endif
+
+#ifdef TREE_KERNEL_AVX2
+// Four vertices at a time.
+__attribute__((target("avx2")))
+static void AVX2(const LeafTemplate &leaf, const LeafBatch &batch, Point *points)
+{
+    const auto size = leaf.size();
+    const auto last = size - size % 4;
+    const double *unitX = leaf.UnitX();
+    const double *unitY = leaf.UnitY();
+
+    for (std::size_t i = 0; i < batch.size(); i++) {
+        const double cos = batch.lenght[i] * CosTable[DegreeIndex(batch.angle[i])];
+        const double sin = batch.lenght[i] * SinTable[DegreeIndex(batch.angle[i])];
+        const __m256d c = _mm256_set1_pd(cos);
+        const __m256d s = _mm256_set1_pd(sin);
+        const __m128i x = _mm_set1_epi32(batch.x[i]);
+        const __m128i y = _mm_set1_epi32(batch.y[i]);
+        Point *point = points + i * size;
+        std::size_t k = 0;
+        for (; k < last; k += 4) {
+            const __m256d ux = _mm256_loadu_pd(unitX + k);
+            const __m256d uy = _mm256_loadu_pd(unitY + k);
+            const __m128i px = _mm_add_epi32(x, _mm256_cvttpd_epi32(_mm256_sub_pd(_mm256_mul_pd(c, ux),
+                                                                                  _mm256_mul_pd(s, uy))));
+            const __m128i py = _mm_add_epi32(y, _mm256_cvttpd_epi32(_mm256_add_pd(_mm256_mul_pd(s, ux),
+                                                                                  _mm256_mul_pd(c, uy))));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(point + k), _mm_unpacklo_epi32(px, py));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(point + k + 2), _mm_unpackhi_epi32(px, py));
+        }
+        if (size - k >= 2) {
+            const __m128d c2 = _mm256_castpd256_pd128(c);
+            const __m128d s2 = _mm256_castpd256_pd128(s);
+            const __m128d ux = _mm_loadu_pd(unitX + k);
+            const __m128d uy = _mm_loadu_pd(unitY + k);
+            const __m128i px = _mm_add_epi32(x, _mm_cvttpd_epi32(_mm_sub_pd(_mm_mul_pd(c2, ux), _mm_mul_pd(s2, uy))));
+            const __m128i py = _mm_add_epi32(y, _mm_cvttpd_epi32(_mm_add_pd(_mm_mul_pd(s2, ux), _mm_mul_pd(c2, uy))));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(point + k), _mm_unpacklo_epi32(px, py));
+            k += 2;
+        }
+        for (; k < size; k++) {
+            point[k].x = batch.x[i] + static_cast<int>(cos * unitX[k] - sin * unitY[k]);
+            point[k].y = batch.y[i] + static_cast<int>(sin * unitX[k] + cos * unitY[k]);
+        }
+    }
+}
+#endif
+
+auto BestKernel() -> Kernel
+{
+#ifdef TREE_KERNEL_AVX2
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx2) {
+        return Kernel::AVX2;
+    }
+#endif
+#ifdef TREE_KERNEL_SSE2
+    return Kernel::SSE2;
+#else
+    return Kernel::Scalar;
+#endif
+}
+
+auto KernelName(Kernel kernel) -> const char *
+{
+    switch (kernel) {
+    case Kernel::Scalar:
+        return "scalar";
+    case Kernel::SSE2:
+        return "SSE2";
+    case Kernel::AVX2:
+        return "AVX2";
+    default:
+        return KernelName(BestKernel());
+    }
+}
+
+void InstantiateBatch(const LeafTemplate &leaf, const LeafBatch &batch, Point *points, Kernel kernel)
+{
+    auto best = BestKernel();
+    if (kernel == Kernel::Auto || (kernel == Kernel::AVX2 && best != Kernel::AVX2) ||
+        (kernel == Kernel::SSE2 && best == Kernel::Scalar)) {
+        kernel = best;
+    }
+
+    switch (kernel) {
+#ifdef TREE_KERNEL_AVX2
+    case Kernel::AVX2:
+        AVX2(leaf, batch, points);
+        break;
+#endif
+#ifdef TREE_KERNEL_SSE2
+    case Kernel::SSE2:
+        SSE2(leaf, batch, points);
+        break;
+#endif
+    default:
+        Scalar(leaf, batch, points);
+        break;
+    }
+}
+
+// Single leaf, used by LeafTemplate::Instantiate so that every path gives the same points.
+void InstantiateLeaf(const LeafTemplate &leaf, Point pos, unsigned lenght, unsigned angle, Point *points)
+{
+    const double *unitX = leaf.UnitX();
+    const double *unitY = leaf.UnitY();
+    const double c = lenght * CosTable[DegreeIndex(angle)];
+    const double s = lenght * SinTable[DegreeIndex(angle)];
+    for (std::size_t k = 0; k < leaf.size(); k++) {
+        points[k].x = pos.x + static_cast<int>(c * unitX[k] - s * unitY[k]);
+        points[k].y = pos.y + static_cast<int>(s * unitX[k] + c * unitY[k]);
+    }
+}
+
+} // namespace Tree
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+#include "tree.h"
+
+/*
+ * Batch instantiation of leafs.
+ *
+ * Every leaf of a batch uses the same template and is written, in order, to one flat buffer.
+ * The SSE2 and AVX2 kernels give the same points as the scalar one.
+ */
+namespace Tree {
+
+// Leafs in structure-of-arrays form.
+struct LeafBatch {
+    std::vector<int> x;
+    std::vector<int> y;
+    std::vector<unsigned> angle;
+    std::vector<unsigned> lenght;
+
+    void clear()
+    {
+        x.clear();
+        y.clear();
+        angle.clear();
+        lenght.clear();
+    }
+
+    void push(Point pos, unsigned leafLenght, unsigned leafAngle)
+    {
+        x.push_back(pos.x);
+        y.push_back(pos.y);
+        angle.push_back(leafAngle);
+        lenght.push_back(leafLenght);
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t { return x.size(); }
+    [[nodiscard]] auto empty() const -> bool { return x.empty(); }
+};
+
+enum class Kernel { Auto, Scalar, SSE2, AVX2 };
+
+// Best kernel supported by this processor.
+auto BestKernel() -> Kernel;
+auto KernelName(Kernel kernel) -> const char *;
+
+// Writes batch.size() * leaf.size() points, unsupported kernels fall back to the best one.
+void InstantiateBatch(const LeafTemplate &leaf, const LeafBatch &batch, Point *points, Kernel kernel = Kernel::Auto);
+
+// Writes leaf.size() points, same rounding as the batch kernels.
+void InstantiateLeaf(const LeafTemplate &leaf, Point pos, unsigned lenght, unsigned angle, Point *points);
+
+} // namespace Tree
@@ -0,0 +1,185 @@
+#include "profiler.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace Tree {
+
+namespace {
+
+constexpr auto PhaseCount = static_cast<std::size_t>(Profiler::Phase::Count);
+constexpr auto CounterCount = static_cast<std::size_t>(Profiler::Counter::Count);
+
+// Complete event of the trace, in ns since the start of the trace.
+struct Event {
+    Profiler::Phase phase;
+    unsigned thread;
+    std::uint64_t start;
+    std::uint64_t duration;
+};
+
+std::mutex mutex;
+Profiler::Stats stats[PhaseCount];
+bool isTracing = false;
+std::chrono::steady_clock::time_point traceStart;
+std::vector<Event> events;
+
+// Small ids for the trace viewers, in order of the first recorded scope.
+auto ThreadId() -> unsigned
+{
+    static std::atomic<unsigned> next = 1;
+    thread_local unsigned id = next.fetch_add(1, std::memory_order_relaxed);
+
+    return id;
+}
+
+auto Milliseconds(std::uint64_t ns) -> double
+{
+    return static_cast<double>(ns) / 1e6;
+}
+
+} // namespace
+
+auto Profiler::Name(Phase phase) -> const char *
+{
+    constexpr const char *names[PhaseCount] = {"Update", "Rebuild", "Draw", "Paint", "Export", "Save"};
+
+    return names[static_cast<std::size_t>(phase)];
+}
+
+auto Profiler::Name(Counter counter) -> const char *
+{
+    constexpr const char *names[CounterCount] = {"shapes", "vertices", "bytes"};
+
+    return names[static_cast<std::size_t>(counter)];
+}
+
+void Profiler::Record(Phase phase, Clock::time_point start, Clock::time_point end)
+{
+    auto duration = static_cast<std::uint64_t>(std::chrono::nanoseconds(end - start).count());
+    auto thread = ThreadId();
+
+    std::lock_guard lock(mutex);
+    auto &stat = stats[static_cast<std::size_t>(phase)];
+    stat.calls++;
+    stat.total += duration;
+    stat.last = duration;
+    if (isTracing && start >= traceStart) {
+        auto offset = static_cast<std::uint64_t>(std::chrono::nanoseconds(start - traceStart).count());
+        events.push_back({phase, thread, offset, duration});
+    }
+}
+
+auto Profiler::Get(Phase phase) -> Stats
+{
+    std::lock_guard lock(mutex);
+
+    return stats[static_cast<std::size_t>(phase)];
+}
+
+auto Profiler::Get([[maybe_unused]] Counter counter) -> std::uint64_t
+{
+#ifdef SVGTREE_NO_PROFILE
+    return 0;
+#else
+    return counters[static_cast<std::size_t>(counter)].load(std::memory_order_relaxed);
+#endif
+}
+
+void Profiler::Reset()
+{
+    std::lock_guard lock(mutex);
+    for (auto &stat : stats) {
+        stat = {};
+    }
+#ifndef SVGTREE_NO_PROFILE
+    for (auto &counter : counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+#endif
+}
+
+auto Profiler::Summary() -> std::string
+{
+    std::string summary;
+    {
+        std::lock_guard lock(mutex);
+        for (std::size_t p = 0; p < PhaseCount; p++) {
+            if (stats[p].calls == 0) {
+                continue;
+            }
+            char text[96];
+            std::snprintf(text, sizeof(text), "%s %.1f ms (avg %.1f)  ", Name(static_cast<Phase>(p)),
+                          Milliseconds(stats[p].last), Milliseconds(stats[p].total / stats[p].calls));
+            summary += text;
+        }
+    }
+    for (std::size_t c = 0; c < CounterCount; c++) {
+        summary += std::string(Name(static_cast<Counter>(c))) + " " + std::to_string(Get(static_cast<Counter>(c))) + "  ";
+    }
+    summary.resize(summary.size() - 2);
+
+    return summary;
+}
+
+void Profiler::StartTrace()
+{
+    {
+        std::lock_guard lock(mutex);
+        events.clear();
+        traceStart = Clock::now();
+        isTracing = true;
+    }
+    Enable(true);
+}
+
+auto Profiler::Tracing() -> bool
+{
+    std::lock_guard lock(mutex);
+
+    return isTracing;
+}
+
+auto Profiler::StopTrace(const std::string &filename) -> bool
+{
+    std::vector<Event> recorded;
+    {
+        std::lock_guard lock(mutex);
+        isTracing = false;
+        recorded.swap(events);
+    }
+    if (filename.empty()) {
+        return true;
+    }
+
+    std::ofstream file(filename, std::ios::out | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Error handling file writing: " << filename << "\n";
+        return false;
+    }
+
+    // Trace event format: complete events ("X"), times in microseconds
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (std::size_t i = 0; i < recorded.size(); i++) {
+        auto &event = recorded[i];
+        char line[160];
+        std::snprintf(line, sizeof(line),
+                      "{\"name\":\"%s\",\"cat\":\"svgtree\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+                      Name(event.phase), event.thread, static_cast<double>(event.start) / 1e3,
+                      static_cast<double>(event.duration) / 1e3, i + 1 < recorded.size() ? "," : "");
+        file << line;
+    }
+    file << "]}\n";
+
+    if (!file) {
+        std::cerr << "Error handling file writing: " << filename << "\n";
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace Tree
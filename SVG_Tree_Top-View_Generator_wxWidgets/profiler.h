@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/*
+ * Timers and counters of the hot paths.
+ *
+ * Disabled until Enable(true): a scope then costs one relaxed atomic load. Enabled, each phase keeps its number of
+ * calls, total and last duration. While a trace is recorded every timed scope is also kept as a complete event
+ * of the Chrome trace format, for chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Built without it (-DSVGTREE_PROFILE=OFF) the scopes and counters are empty.
+ */
+namespace Tree {
+
+class Profiler {
+    using Clock = std::chrono::steady_clock;
+
+public:
+    enum class Phase { Update, Rebuild, Draw, Paint, Export, Save, Count };
+    enum class Counter { Shapes, Vertices, Bytes, Count };
+
+    struct Stats {
+        std::uint64_t calls = 0;
+        std::uint64_t total = 0;    // ns
+        std::uint64_t last = 0;     // ns
+    };
+
+#ifdef SVGTREE_NO_PROFILE
+    class Scope {
+    public:
+        explicit Scope(Phase) {}
+    };
+
+    static void Add(Counter, std::uint64_t) {}
+    static void Enable(bool) {}
+    [[nodiscard]] static auto Enabled() -> bool { return false; }
+#else
+    // Times the enclosing block.
+    class Scope {
+    public:
+        explicit Scope(Phase phase) : phase(phase), isActive(Enabled())
+        {
+            if (isActive) {
+                start = Clock::now();
+            }
+        }
+
+        ~Scope()
+        {
+            if (isActive) {
+                Record(phase, start, Clock::now());
+            }
+        }
+
+        Scope(const Scope &) = delete;
+        auto operator=(const Scope &) -> Scope & = delete;
+
+    private:
+        Phase phase;
+        bool isActive;
+        Clock::time_point start;
+    };
+
+    static void Add(Counter counter, std::uint64_t value)
+    {
+        if (Enabled()) {
+            counters[static_cast<int>(counter)].fetch_add(value, std::memory_order_relaxed);
+        }
+    }
+
+    static void Enable(bool value) { isEnabled.store(value, std::memory_order_relaxed); }
+    [[nodiscard]] static auto Enabled() -> bool { return isEnabled.load(std::memory_order_relaxed); }
+#endif
+
+    static auto Get(Phase phase) -> Stats;
+    static auto Get(Counter counter) -> std::uint64_t;
+    static void Reset();
+
+    // One line: last and mean duration of each phase that ran, then the counters.
+    static auto Summary() -> std::string;
+
+    // Keeps the events from now on, enables the profiler.
+    static void StartTrace();
+    // Writes the events kept since StartTrace as JSON and stops keeping them, an empty filename drops them.
+    static auto StopTrace(const std::string &filename) -> bool;
+    [[nodiscard]] static auto Tracing() -> bool;
+
+    static auto Name(Phase phase) -> const char *;
+    static auto Name(Counter counter) -> const char *;
+
+private:
+    static inline std::atomic<bool> isEnabled = false;
+    static inline std::atomic<std::uint64_t> counters[static_cast<int>(Counter::Count)] = {};
+
+    static void Record(Phase phase, Clock::time_point start, Clock::time_point end);
+};
+
+} // namespace Tree
@@ -0,0 +1,253 @@
+#include "project.h"
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Tree {
+
+static_assert(sizeof(Point) == 8 && sizeof(Point::x) == 4, "points are read in place as int32 pairs");
+
+constexpr char Magic[8] = {'S', 'V', 'G', 'T', 'R', 'E', 'E', '\0'};
+constexpr std::size_t HeaderSize = 80;
+constexpr std::size_t PathSize = 32;
+constexpr std::size_t PointSize = 8;
+
+ProjectFile::~ProjectFile()
+{
+    Close();
+}
+
+auto ProjectFile::Get32(std::size_t offset) const -> std::uint32_t
+{
+    auto *p = data + offset;
+    return p[0] | p[1] << 8 | p[2] << 16 | static_cast<std::uint32_t>(p[3]) << 24;
+}
+
+auto ProjectFile::Get64(std::size_t offset) const -> std::uint64_t
+{
+    return Get32(offset) | static_cast<std::uint64_t>(Get32(offset + 4)) << 32;
+}
+
+auto ProjectFile::Open(const std::string &filename) -> bool
+{
+    Close();
+
+#ifndef _WIN32
+    if constexpr (std::endian::native == std::endian::little) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        struct stat status {};
+        if (fd >= 0 && ::fstat(fd, &status) == 0 && status.st_size > 0) {
+            void *map = ::mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (map != MAP_FAILED) {
+                data = static_cast<const unsigned char *>(map);
+                size = status.st_size;
+                isMapped = true;
+            }
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+#endif
+
+    if (!isMapped) {
+        // Copy of the file, points in the byte order of this machine
+        std::ifstream file(filename, std::ios::binary);
+        buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data = buffer.data();
+        size = buffer.size();
+    }
+
+    if (!Valid(filename)) {
+        Close();
+        return false;
+    }
+
+    if constexpr (std::endian::native != std::endian::little) {
+        auto *point = reinterpret_cast<std::uint32_t *>(buffer.data() + HeaderSize + paths * PathSize);
+        for (std::size_t i = 0; i < 2 * points; i++) {
+            point[i] = std::byteswap(point[i]);
+        }
+    }
+
+    return true;
+}
+
+auto ProjectFile::Valid(const std::string &filename) -> bool
+{
+    auto error = [&](const char *message) {
+        std::cerr << "Error handling file reading: " << filename << ": " << message << "\n";
+        return false;
+    };
+
+    if (size < HeaderSize || std::memcmp(data, Magic, sizeof(Magic)) != 0) {
+        return error("not a project file");
+    }
+    if (Get32(8) > Version) {
+        return error("newer project version");
+    }
+    paths = Get32(56);
+    points = Get64(64);
+    if (points > size / PointSize || size != HeaderSize + paths * PathSize + points * PointSize) {
+        return error("truncated project");
+    }
+    for (std::size_t i = 0; i < paths; i++) {
+        auto record = HeaderSize + i * PathSize;
+        auto first = Get64(record + 24);
+        if (first > points || Get32(record + 20) > points - first) {
+            return error("invalid path");
+        }
+    }
+
+    return true;
+}
+
+void ProjectFile::Close()
+{
+#ifndef _WIN32
+    if (isMapped) {
+        ::munmap(const_cast<unsigned char *>(data), size);
+    }
+#endif
+    data = nullptr;
+    size = 0;
+    paths = 0;
+    points = 0;
+    isMapped = false;
+    buffer = {};
+}
+
+auto ProjectFile::Points(std::size_t path) const -> std::span<const Point>
+{
+    auto record = HeaderSize + path * PathSize;
+    auto *first = reinterpret_cast<const Point *>(data + HeaderSize + paths * PathSize) + Get64(record + 24);
+
+    return {first, Get32(record + 20)};
+}
+
+void ProjectFile::Load(Drawing &drawing) const
+{
+    auto colour = [&](std::size_t offset) {
+        return Colour(data[offset], data[offset + 1], data[offset + 2], data[offset + 3]);
+    };
+
+    auto &generator = drawing.generator;
+    auto flags = Get32(12);
+    generator.isSpline = flags & 1;
+    generator.randomColorShapeBrush = flags & 2;
+    drawing.width = static_cast<std::int32_t>(Get32(16));
+    drawing.height = static_cast<std::int32_t>(Get32(20));
+    generator.lineWidth = Get32(24);
+    drawing.seed = Get32(28);
+    generator.colorLinePen = colour(32);
+    generator.colorLineBrush = colour(36);
+    generator.colorShapePen = colour(40);
+    generator.colorShapeBrush = colour(44);
+    generator.minColorShapeBrush = colour(48);
+    generator.maxColorShapeBrush = colour(52);
+
+    drawing.paths.resize(paths);
+    for (std::size_t i = 0; i < paths; i++) {
+        auto record = HeaderSize + i * PathSize;
+        auto &path = drawing.paths[i];
+        path.shapeNumber = Get32(record);
+        path.shapeAngle = Get32(record + 4);
+        path.shapeLenght = Get32(record + 8);
+        path.limitLength = Get32(record + 12);
+        path.seed = Get32(record + 16);
+        auto source = Points(i);
+        path.points.assign(source.begin(), source.end());
+    }
+}
+
+auto ProjectFile::Save(const std::string &filename, const Drawing &drawing) -> bool
+{
+    SVG::FileSink file(filename);
+    auto put32 = [&](std::uint32_t value) {
+        char bytes[4] = {char(value), char(value >> 8), char(value >> 16), char(value >> 24)};
+        file.put(bytes, sizeof(bytes));
+    };
+    auto put64 = [&](std::uint64_t value) {
+        put32(static_cast<std::uint32_t>(value));
+        put32(static_cast<std::uint32_t>(value >> 32));
+    };
+    auto colour = [&](const Colour & value) {
+        char bytes[4] = {char(value.red), char(value.green), char(value.blue), char(value.alpha)};
+        file.put(bytes, sizeof(bytes));
+    };
+
+    auto &generator = drawing.generator;
+    std::uint64_t points = 0;
+    for (auto &path : drawing.paths) {
+        points += path.points.size();
+    }
+
+    // Header
+    file.put(Magic, sizeof(Magic));
+    put32(Version);
+    put32((generator.isSpline ? 1 : 0) | (generator.randomColorShapeBrush ? 2 : 0));
+    put32(static_cast<std::uint32_t>(drawing.width));
+    put32(static_cast<std::uint32_t>(drawing.height));
+    put32(generator.lineWidth);
+    put32(drawing.seed);
+    colour(generator.colorLinePen);
+    colour(generator.colorLineBrush);
+    colour(generator.colorShapePen);
+    colour(generator.colorShapeBrush);
+    colour(generator.minColorShapeBrush);
+    colour(generator.maxColorShapeBrush);
+    put32(drawing.paths.size());
+    put32(0);
+    put64(points);
+    put64(0);
+
+    // Paths
+    std::uint64_t first = 0;
+    for (auto &path : drawing.paths) {
+        put32(path.shapeNumber);
+        put32(path.shapeAngle);
+        put32(path.shapeLenght);
+        put32(path.limitLength);
+        put32(path.seed);
+        put32(path.points.size());
+        put64(first);
+        first += path.points.size();
+    }
+
+    // Points
+    for (auto &path : drawing.paths) {
+        if constexpr (std::endian::native == std::endian::little) {
+            file.put(reinterpret_cast<const char *>(path.points.data()), path.points.size() * sizeof(Point));
+        }
+        else {
+            for (auto &point : path.points) {
+                put32(static_cast<std::uint32_t>(point.x));
+                put32(static_cast<std::uint32_t>(point.y));
+            }
+        }
+    }
+
+    return file.close();
+}
+
+auto ReadProject(const std::string &filename, Drawing &drawing) -> bool
+{
+    ProjectFile file;
+    if (!file.Open(filename)) {
+        return false;
+    }
+    file.Load(drawing);
+
+    return true;
+}
+
+} // namespace Tree
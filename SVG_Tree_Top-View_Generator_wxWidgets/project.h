@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "tree.h"
+
+/*
+ * Binary project: the drawn paths and the parameters needed to generate the tree again.
+ *
+ * Little-endian, version 1:
+ *
+ *      header      80 bytes    magic "SVGTREE\0", version, flags (1 spline, 2 random), width, height,
+ *                              lineWidth, seed, 6 RGBA colours, number of paths, number of points
+ *      paths       32 bytes    shapeNumber, shapeAngle, shapeLenght, limitLength, seed, points, first point
+ *      points       8 bytes    x, y as int32
+ *
+ * Opened files are memory mapped where the system allows it. Points() reads the points in place, Load() copies
+ * them once into the paths, which the generator needs as vectors.
+ */
+namespace Tree {
+
+class ProjectFile {
+public:
+    static constexpr std::uint32_t Version = 1;
+    static constexpr const char *Extension = ".svgtree";
+
+    ProjectFile() = default;
+    ~ProjectFile();
+
+    ProjectFile(const ProjectFile &) = delete;
+    auto operator=(const ProjectFile &) -> ProjectFile & = delete;
+
+    auto Open(const std::string &filename) -> bool;
+    void Close();
+
+    [[nodiscard]] auto Paths() const -> std::size_t { return paths; }
+
+    // Points of a path, valid until Close.
+    [[nodiscard]] auto Points(std::size_t path) const -> std::span<const Point>;
+
+    // Parameters and copies of the paths.
+    void Load(Drawing &drawing) const;
+
+    static auto Save(const std::string &filename, const Drawing &drawing) -> bool;
+
+private:
+    const unsigned char *data = nullptr;
+    std::size_t size = 0;
+    std::size_t paths = 0;
+    std::size_t points = 0;
+    bool isMapped = false;
+    std::vector<unsigned char> buffer;  // when the file can not be mapped
+
+    [[nodiscard]] auto Get32(std::size_t offset) const -> std::uint32_t;
+    [[nodiscard]] auto Get64(std::size_t offset) const -> std::uint64_t;
+    [[nodiscard]] auto Valid(const std::string &filename) -> bool;
+};
+
+auto ReadProject(const std::string &filename, Drawing &drawing) -> bool;
+
+} // namespace Tree
@@ -0,0 +1,80 @@
+#include "rebuilder.h"
+
+#include "profiler.h"
+
+namespace Tree {
+
+Rebuilder::Rebuilder(ThreadPool &pool, Callback callback, ArenaPool arenas)
+    : pool(pool), callback(std::move(callback)), arenas(std::move(arenas)), worker([this]() { Run(); })
+{
+}
+
+Rebuilder::~Rebuilder()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+        next.reset();
+        running.request_stop();
+    }
+    available.notify_all();
+    worker.join();
+}
+
+auto Rebuilder::Request(Generator generator, std::vector<Path> paths) -> unsigned
+{
+    unsigned current = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current = ++generation;
+        next = Job{current, std::move(generator), std::move(paths)};
+        running.request_stop();
+    }
+    available.notify_one();
+
+    return current;
+}
+
+void Rebuilder::Cancel()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    generation++;
+    next.reset();
+    running.request_stop();
+}
+
+auto Rebuilder::Generation() const -> unsigned
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return generation;
+}
+
+void Rebuilder::Run()
+{
+    while (true) {
+        Job job;
+        std::stop_source source;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            available.wait(lock, [this]() { return stop || next.has_value(); });
+            if (stop) {
+                return;
+            }
+            job = std::move(*next);
+            next.reset();
+            running = source;
+        }
+
+        auto result = std::make_shared<Result>();
+        result->generation = job.generation;
+        Profiler::Scope scope(Profiler::Phase::Rebuild);
+        result->arena = arenas.Get();
+        result->count = job.generator.Update(job.paths, result->branches, pool, source.get_token(),
+                                             result->arena.get());
+        if (!source.stop_requested()) {
+            callback(std::move(result));
+        }
+    }
+}
+
+} // namespace Tree
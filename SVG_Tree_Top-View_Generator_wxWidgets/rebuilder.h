@@ -0,0 +1,71 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "arena.h"
+#include "tree.h"
+#include "threadPool.h"
+
+namespace Tree {
+
+/*
+ * Full rebuilds on a background thread.
+ *
+ * Only the newest request is kept: a new request replaces the waiting one and stops the running one.
+ * Results of stopped rebuilds are dropped, the others are given to the callback on the worker thread.
+ * The geometry of each result is in an arena of the pool, taken back once the result and its arena are dropped.
+ */
+class Rebuilder {
+public:
+    struct Result {
+        unsigned generation = 0;
+        unsigned count = 0;     // generated shapes
+        std::shared_ptr<Arena> arena;   // memory of the branches, kept as long as they are
+        std::vector<Branch> branches;
+    };
+
+    using Callback = std::function<void(std::shared_ptr<Result>)>;
+
+    Rebuilder(ThreadPool &pool, Callback callback, ArenaPool arenas = {});
+    ~Rebuilder();
+
+    Rebuilder(const Rebuilder &) = delete;
+    auto operator=(const Rebuilder &) -> Rebuilder & = delete;
+
+    // Returns the generation of the request.
+    auto Request(Generator generator, std::vector<Path> paths) -> unsigned;
+
+    // Drops the waiting request and stops the running one.
+    void Cancel();
+
+    // Generation of the newest request, older results are stale.
+    [[nodiscard]] auto Generation() const -> unsigned;
+
+private:
+    struct Job {
+        unsigned generation = 0;
+        Generator generator;
+        std::vector<Path> paths;
+    };
+
+    ThreadPool &pool;
+    Callback callback;
+    ArenaPool arenas;
+    mutable std::mutex mutex;
+    std::condition_variable available;
+    std::optional<Job> next;
+    std::stop_source running;
+    unsigned generation = 0;
+    bool stop = false;
+    std::thread worker;
+
+    void Run();
+};
+
+} // namespace Tree
@@ -0,0 +1,174 @@
+#include "spatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Tree {
+
+// Even-odd rule, as the polygons are filled.
+static auto Inside(Point point, std::span<const Point> polygon) -> bool
+{
+    bool inside = false;
+    for (std::size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+        auto &a = polygon[i];
+        auto &b = polygon[j];
+        if ((a.y > point.y) != (b.y > point.y) &&
+            point.x < static_cast<double>(b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x) {
+            inside = !inside;
+        }
+    }
+
+    return inside;
+}
+
+static auto Near(Point point, Point a, Point b, double tolerance) -> bool
+{
+    double dx = b.x - a.x;
+    double dy = b.y - a.y;
+    double lenght = dx * dx + dy * dy;
+    double t = lenght > 0 ? ((point.x - a.x) * dx + (point.y - a.y) * dy) / lenght : 0;
+    t = std::clamp(t, 0.0, 1.0);
+
+    return std::hypot(point.x - (a.x + t * dx), point.y - (a.y + t * dy)) <= tolerance;
+}
+
+SpatialGrid::SpatialGrid(int width, int height, int cellSize) : cellSize(std::max(cellSize, 1))
+{
+    reset(width, height);
+}
+
+void SpatialGrid::reset(int width, int height)
+{
+    columns = std::max(1, (width + cellSize - 1) / cellSize);
+    rows = std::max(1, (height + cellSize - 1) / cellSize);
+    cells.assign(static_cast<std::size_t>(columns) * rows, {});
+    count = 0;
+}
+
+void SpatialGrid::clear()
+{
+    // Keeps the capacity of the cells
+    for (auto &cell : cells) {
+        cell.clear();
+    }
+    count = 0;
+}
+
+auto SpatialGrid::column(int x) const -> int
+{
+    return std::clamp(x / cellSize, 0, columns - 1);
+}
+
+auto SpatialGrid::row(int y) const -> int
+{
+    return std::clamp(y / cellSize, 0, rows - 1);
+}
+
+void SpatialGrid::insert(const Entry &entry)
+{
+    if (entry.box.empty()) {
+        return;
+    }
+    for (int y = row(entry.box.min.y); y <= row(entry.box.max.y); y++) {
+        for (int x = column(entry.box.min.x); x <= column(entry.box.max.x); x++) {
+            cells[y * columns + x].push_back(entry);
+        }
+    }
+    count++;
+}
+
+void SpatialGrid::build(const std::vector<Branch> &branches)
+{
+    clear();
+    for (unsigned i = 0; i < branches.size(); i++) {
+        insert(i, branches[i]);
+    }
+}
+
+void SpatialGrid::insert(unsigned index, const Branch &branch, std::size_t leafs, std::size_t segments)
+{
+    for (auto i = leafs; i < branch.leafs.size(); i++) {
+        insert(Entry{branch.leafs.bounds(i), index, static_cast<unsigned>(i)});
+    }
+    auto &points = branch.line.points;
+    for (auto i = segments; i + 1 < points.size(); i++) {
+        Box box;
+        box.add(points[i]);
+        box.add(points[i + 1]);
+        insert(Entry{box, index, static_cast<unsigned>(i) | Line});
+    }
+}
+
+void SpatialGrid::erase(unsigned index, const Branch &branch)
+{
+    if (branch.bounds.empty()) {
+        return;
+    }
+    for (int y = row(branch.bounds.min.y); y <= row(branch.bounds.max.y); y++) {
+        for (int x = column(branch.bounds.min.x); x <= column(branch.bounds.max.x); x++) {
+            auto &cell = cells[y * columns + x];
+            // An entry is counted in the cell of its first corner
+            for (auto &entry : cell) {
+                if (entry.branch == index && column(entry.box.min.x) == x && row(entry.box.min.y) == y) {
+                    count--;
+                }
+            }
+            std::erase_if(cell, [&](const Entry & entry) { return entry.branch == index; });
+        }
+    }
+}
+
+void SpatialGrid::query(const Box &box, std::vector<Entry> &result) const
+{
+    if (box.empty()) {
+        return;
+    }
+    for (int y = row(box.min.y); y <= row(box.max.y); y++) {
+        for (int x = column(box.min.x); x <= column(box.max.x); x++) {
+            for (auto &entry : cells[y * columns + x]) {
+                // Reported only in the cell of the first common point
+                if (entry.box.intersects(box) &&
+                    column(std::max(entry.box.min.x, box.min.x)) == x && row(std::max(entry.box.min.y, box.min.y)) == y) {
+                    result.push_back(entry);
+                }
+            }
+        }
+    }
+}
+
+auto SpatialGrid::at(Point point, const std::vector<Branch> &branches, unsigned lineWidth) const -> int
+{
+    double tolerance = lineWidth / 2.0 + 1;
+    int margin = static_cast<int>(tolerance) + 1;
+    thread_local std::vector<Entry> candidates;
+    candidates.clear();
+    query(Box(point - Point(margin, margin), point + Point(margin, margin)), candidates);
+
+    // Topmost first: later branches, then the line, then later leafs
+    std::sort(candidates.begin(), candidates.end(), [](const Entry & a, const Entry & b) {
+        return a.branch != b.branch ? a.branch > b.branch : a.shape > b.shape;
+    });
+    for (auto &entry : candidates) {
+        if (entry.branch >= branches.size()) {
+            continue;
+        }
+        auto &branch = branches[entry.branch];
+        if (entry.shape & Line) {
+            auto i = entry.shape & ~Line;
+            if (lineWidth > 0 && i + 1 < branch.line.points.size() &&
+                Near(point, branch.line.points[i], branch.line.points[i + 1], tolerance)) {
+                return entry.branch;
+            }
+        }
+        else if (entry.shape < branch.leafs.size()) {
+            auto points = branch.leafs.points(entry.shape);
+            if (points.size() < 3 ? points.size() == 2 && Near(point, points[0], points[1], 1) : Inside(point, points)) {
+                return entry.branch;
+            }
+        }
+    }
+
+    return -1;
+}
+
+} // namespace Tree
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+
+#include "tree.h"
+
+/*
+ * Uniform grid over the bounding boxes of the generated shapes.
+ *
+ * Each leaf and each segment of a branch line is kept in every cell its box crosses.
+ * Queries visit only the cells of the box or point, shapes outside the canvas go to the border cells.
+ */
+namespace Tree {
+
+class SpatialGrid {
+public:
+    struct Entry {
+        Box box;
+        unsigned branch = 0;
+        unsigned shape = 0;     // leaf index, or segment index with the Line flag
+    };
+
+    static constexpr unsigned Line = 1u << 31;
+
+    SpatialGrid(int width = 0, int height = 0, int cellSize = 64);
+
+    // Empty grid over a new canvas.
+    void reset(int width, int height);
+    void clear();
+
+    void build(const std::vector<Branch> &branches);
+
+    // Leafs from "leafs" on and line segments from "segments" on, after an update of the branch.
+    void insert(unsigned index, const Branch &branch, std::size_t leafs = 0, std::size_t segments = 0);
+
+    // All shapes of the branch, found through its bounds.
+    void erase(unsigned index, const Branch &branch);
+
+    // Entries crossing the box, each one once and in no particular order.
+    void query(const Box &box, std::vector<Entry> &result) const;
+
+    // Branch of the topmost shape under the point, -1 if there is none.
+    [[nodiscard]] auto at(Point point, const std::vector<Branch> &branches, unsigned lineWidth) const -> int;
+
+    [[nodiscard]] auto size() const -> std::size_t { return count; }
+
+private:
+    int cellSize;
+    int columns = 1;
+    int rows = 1;
+    std::size_t count = 0;
+    std::vector<std::vector<Entry>> cells;
+
+    void insert(const Entry &entry);
+    [[nodiscard]] auto column(int x) const -> int;
+    [[nodiscard]] auto row(int y) const -> int;
+};
+
+} // namespace Tree
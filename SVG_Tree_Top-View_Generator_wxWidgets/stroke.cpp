@@ -0,0 +1,120 @@
+#include "stroke.h"
+
+#include <algorithm>
+
+namespace Tree {
+
+// Squared distance from the point to the segment.
+static auto SegmentDistance2(Point point, Point a, Point b) -> double
+{
+    double dx = b.x - a.x;
+    double dy = b.y - a.y;
+    double lenght = dx * dx + dy * dy;
+    double t = lenght > 0 ? ((point.x - a.x) * dx + (point.y - a.y) * dy) / lenght : 0;
+    t = std::clamp(t, 0.0, 1.0);
+    double x = point.x - (a.x + t * dx);
+    double y = point.y - (a.y + t * dy);
+
+    return x * x + y * y;
+}
+
+void StrokeSimplifier::SetTolerance(double value)
+{
+    tolerance = std::max(value, 0.0);
+}
+
+void StrokeSimplifier::Begin(unsigned limitLength)
+{
+    this->limitLength = limitLength;
+    isStarted = false;
+    pending.clear();
+}
+
+void StrokeSimplifier::Begin(const Path &path, Point anchor)
+{
+    // The first point alone has no leafs yet: the next sample starts the branch as in a new stroke
+    Begin(path.limitLength);
+    if (path.points.size() > 1) {
+        this->anchor = anchor;
+        last = path.points.back();
+        isStarted = true;
+    }
+}
+
+void StrokeSimplifier::Append(Point point, std::vector<Point> &points)
+{
+    points.push_back(point);
+    last = point;
+    pending.clear();
+}
+
+auto StrokeSimplifier::Fits(Point end) const -> bool
+{
+    auto limit = tolerance * tolerance;
+    for (auto &point : pending) {
+        if (SegmentDistance2(point, last, end) > limit) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto StrokeSimplifier::Add(Point sample, std::vector<Point> &points) -> bool
+{
+    if (tolerance <= 0 || !isStarted) {
+        Append(sample, points);
+        anchor = sample;
+        isStarted = true;
+        return true;
+    }
+    if (sample == (pending.empty() ? last : pending.back())) {
+        return false;   // the mouse did not move
+    }
+
+    // The segment to the new sample must still cover the samples kept back
+    bool isAppended = false;
+    if (!pending.empty() && (pending.size() >= MaxPending || !Fits(sample))) {
+        Append(pending.back(), points);
+        isAppended = true;
+    }
+
+    // Same test as the generator
+    if (limitLength > 0 && Distance(sample.x, sample.y, anchor.x, anchor.y) > limitLength) {
+        Append(sample, points);
+        anchor = sample;
+        return true;
+    }
+    pending.push_back(sample);
+
+    return isAppended;
+}
+
+auto StrokeSimplifier::Finish(std::vector<Point> &points) -> bool
+{
+    if (pending.empty()) {
+        return false;
+    }
+    Append(pending.back(), points);
+
+    return true;
+}
+
+void Simplify(Path &path, double tolerance)
+{
+    if (tolerance <= 0 || path.points.size() < 3) {
+        return;
+    }
+
+    StrokeSimplifier simplifier(tolerance);
+    simplifier.Begin(path.limitLength);
+    std::vector<Point> points = {path.points.front()};
+    points.reserve(path.points.size());
+    for (std::size_t i = 1; i < path.points.size(); i++) {
+        simplifier.Add(path.points[i], points);
+    }
+    simplifier.Finish(points);
+    path.points = std::move(points);
+}
+
+} // namespace Tree
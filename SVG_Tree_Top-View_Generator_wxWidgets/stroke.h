@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+
+#include "tree.h"
+
+/*
+ * Simplification of the mouse samples of a stroke, while it is drawn.
+ *
+ * A sample is kept back while all the samples since the last kept point stay within the tolerance of the segment
+ * from that point to it. Once one does not, the previous sample is appended: duplicate and nearly collinear samples
+ * never reach the path. Points are only appended, so the branch can still be updated incrementally.
+ *
+ * The samples where Generator::Update places leafs, farther than the leaf distance from the previous one,
+ * are always kept: the leafs are the same as with every sample, only the branch line is simplified.
+ */
+namespace Tree {
+
+class StrokeSimplifier {
+public:
+    // Pixels, 0 keeps every sample.
+    explicit StrokeSimplifier(double tolerance = 0) : tolerance(tolerance) {}
+
+    [[nodiscard]] auto Tolerance() const -> double { return tolerance; }
+    void SetTolerance(double value);
+
+    // New stroke with the limitLength of its path, its first sample is always kept.
+    void Begin(unsigned limitLength = 0);
+    // Stroke continuing a path, whose branch last received leafs at anchor (see Branch).
+    void Begin(const Path &path, Point anchor);
+
+    // Returns true if points were appended.
+    auto Add(Point sample, std::vector<Point> &points) -> bool;
+
+    // Appends the sample kept back, at the end of the stroke.
+    auto Finish(std::vector<Point> &points) -> bool;
+
+private:
+    static constexpr std::size_t MaxPending = 64;   // bounds the check of each sample
+
+    double tolerance;
+    unsigned limitLength = 0;
+    bool isStarted = false;
+    Point anchor;               // last sample with leafs
+    Point last;                 // last appended point
+    std::vector<Point> pending; // samples since then
+
+    [[nodiscard]] auto Fits(Point end) const -> bool;
+    void Append(Point point, std::vector<Point> &points);
+};
+
+// Simplifies the points of a drawn path, the first one is left as it is (see Generator::Update).
+void Simplify(Path &path, double tolerance);
+
+} // namespace Tree
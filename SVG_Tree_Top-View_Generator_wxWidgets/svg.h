@@ -1,29 +1,93 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <charconv>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <ctime>
 #include <fstream>
 #include <iostream>
 #include <random>
+#include <span>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <climits>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
 constexpr auto PI = 3.1415926;
 
-inline auto Rad(const double &angle) -> double
+constexpr auto Rad(const double &angle) -> double
 {
     return angle * PI / 180;
 }
 
+// Sine and cosine series evaluated at compile time, so the tables below are the same on every platform.
+constexpr auto SinCosSeries(double x, bool cosine) -> double
+{
+    constexpr double pi = 3.14159265358979323846;
+
+    // Reduces to [-pi/2, pi/2], where the series converges fast.
+    while (x > pi) {
+        x -= 2 * pi;
+    }
+    while (x < -pi) {
+        x += 2 * pi;
+    }
+    double sign = 1;
+    if (x > pi / 2 || x < -pi / 2) {
+        x = x > 0 ? pi - x : -pi - x;
+        sign = cosine ? -1 : 1;
+    }
+
+    double term = cosine ? 1 : x;
+    double sum = term;
+    for (int n = cosine ? 1 : 2; n < 40; n += 2) {
+        term *= -x * x / (n * (n + 1));
+        sum += term;
+    }
+    return sign * sum;
+}
+
+// Values of std::sin(Rad(angle)) and std::cos(Rad(angle)) for the integer angles 0..359.
+constexpr auto SinCosTable(bool cosine) -> std::array<double, 360>
+{
+    std::array<double, 360> table{};
+    for (int angle = 0; angle < 360; angle++) {
+        table[angle] = SinCosSeries(Rad(angle), cosine);
+    }
+    return table;
+}
+
+constexpr std::array<double, 360> SinTable = SinCosTable(false);
+constexpr std::array<double, 360> CosTable = SinCosTable(true);
+
+constexpr auto DegreeIndex(int angle) -> unsigned
+{
+    angle %= 360;
+    return angle < 0 ? angle + 360 : angle;
+}
+
 inline auto Cos(const double &value, const double &radius, const int &angle) -> double
 {
-    return value + radius * std::cos(Rad(angle));
+    return value + radius * CosTable[DegreeIndex(angle)];
 }
 
-inline auto Sin(const double &value, const double &radius, const double &angle) -> double
+inline auto Sin(const double &value, const double &radius, const int &angle) -> double
 {
-    return value + radius * std::sin(Rad(angle));
+    return value + radius * SinTable[DegreeIndex(angle)];
 }
 
 inline auto Distance(const double &x0, const double &y0, const double &x1, const double &y1) -> double
@@ -62,6 +126,52 @@ class SVG {
 
 public:
 
+    // Decimal places of the exported numbers, Full is the shortest text that reads back the same value.
+    enum class Precision { Integer, One, Two, Full };
+
+    // Buffer size that fits any number written by format.
+    static constexpr std::size_t NumberSize = 32;
+
+    // Writes value into buffer (at least NumberSize chars), returns the number of chars written.
+    // Trailing zeros of the fraction are not written.
+    static auto format(char *buffer, double value, Precision precision = Precision::Full) -> std::size_t
+    {
+        std::to_chars_result result;
+        switch (precision) {
+        case Precision::Integer:
+            result = std::to_chars(buffer, buffer + NumberSize, value, std::chars_format::fixed, 0);
+            break;
+        case Precision::One:
+            result = std::to_chars(buffer, buffer + NumberSize, value, std::chars_format::fixed, 1);
+            break;
+        case Precision::Two:
+            result = std::to_chars(buffer, buffer + NumberSize, value, std::chars_format::fixed, 2);
+            break;
+        default:
+            result = std::to_chars(buffer, buffer + NumberSize, value);
+            break;
+        }
+        if (result.ec != std::errc()) {
+            buffer[0] = '0';
+            return 1;
+        }
+
+        auto size = static_cast<std::size_t>(result.ptr - buffer);
+        if (precision == Precision::One || precision == Precision::Two) {
+            while (buffer[size - 1] == '0') {
+                size--;
+            }
+            size -= buffer[size - 1] == '.' ? 1 : 0;
+        }
+        return size;
+    }
+
+    static auto toStr(double value, Precision precision = Precision::Full) -> std::string
+    {
+        char buffer[NumberSize];
+        return {buffer, format(buffer, value, precision)};
+    }
+
     struct Metadata {
         std::string creator = "SVG tree image in top view created automatically by algorithm in C++.";
         std::string title = "SVG Tree Top View";
@@ -82,7 +192,7 @@ public:
 
         [[nodiscard]] auto toStr() const -> std::string
         {
-            return std::to_string(x) + "," + std::to_string(y);
+            return SVG::toStr(x) + "," + SVG::toStr(y);
         }
     };
 
@@ -103,40 +213,33 @@ public:
 
     static auto RGB2HEX(const unsigned &R, const unsigned &G, const unsigned &B)  -> std::string
     {
-        auto int2hex = [](unsigned value) {
-            std::string digits = "0123456789ABCDEF";
-            std::string result;
-            if (value < 16) {
-                result.push_back('0');
-                result.push_back(digits[value % 16]);
-            }
-            else {
-                while (value != 0) {
-                    result = digits[value % 16] + result;
-                    value /= 16;
-                }
-            }
-            return result;
-        };
+        // "#RRGGBB" fits in the small string buffer, no allocation
+        constexpr char digits[] = "0123456789ABCDEF";
+        char hex[7] = {'#'};
+        unsigned i = 1;
+        for (auto value : {R, G, B}) {
+            value = std::min(value, 255u);
+            hex[i++] = digits[value / 16];
+            hex[i++] = digits[value % 16];
+        }
 
-        return "#" + int2hex(R) + int2hex(G) + int2hex(B);
+        return {hex, sizeof(hex)};
     }
 
-    static auto svg(const int &width, const int &height, const std::string &figure,
-                    Metadata metadata) -> std::string
+    // Document start, followed by the figure and the footer.
+    static auto header(const int &width, const int &height, Metadata metadata) -> std::string
     {
-        std::string now;
-        try {
-            std::time_t t = std::time(nullptr);
-            std::tm *const pTm = std::localtime(&t);
-            now = std::to_string(1900 + + pTm->tm_year);
-        }
-        catch (...) {
-            // pass
+        if (metadata.date.empty()) {
+            try {
+                std::time_t t = std::time(nullptr);
+                std::tm *const pTm = std::localtime(&t);
+                metadata.date = std::to_string(1900 + + pTm->tm_year);
+            }
+            catch (...) {
+                // pass
+            }
         }
 
-        metadata.date = metadata.date.empty() ? now : metadata.date;
-
         return {
             "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n"
             "<svg\n"
@@ -201,27 +304,23 @@ public:
             "</metadata>\n"
             "<!--      Created in C++ algorithm       -->\n"
             "<!-- Attention: do not modify this code. -->\n"
-            "\n" + figure + "\n"
-            "  <!-- Attention: do not modify this code. -->\n"
-            "</svg>"
+            "\n"
         };
     }
 
-private:
-
-    static auto rtrimZeros(const std::string &str) -> std::string
+    static auto footer() -> std::string
     {
-        auto right = str.size() - 1;
-        while (right >= 0) {
-            if (str[right] != '0') {
-                break;
-            }
-            right--;
-        }
+        return "\n  <!-- Attention: do not modify this code. -->\n</svg>";
+    }
 
-        return str.substr(0, 1 + right) + '0';
+    static auto svg(const int &width, const int &height, const std::string &figure,
+                    Metadata metadata) -> std::string
+    {
+        return header(width, height, std::move(metadata)) + figure + footer();
     }
 
+private:
+
     // Validates and formats entries.
     static auto style(std::string name, std::string fill, std::string stroke, double strokeWidth,
                       double fillOpacity, double strokeOpacity) -> std::string
@@ -234,9 +333,9 @@ private:
 
         return {
             "id=\"" + name + "\"\nstyle=\"" +
-            "opacity:" + rtrimZeros(std::to_string(fillOpacity)) + ";fill:" + fill +
-            ";stroke:" + stroke + ";stroke-width:" + rtrimZeros(std::to_string(strokeWidth)) +
-            ";stroke-opacity:" + rtrimZeros(std::to_string(strokeOpacity)) +
+            "opacity:" + toStr(fillOpacity) + ";fill:" + fill +
+            ";stroke:" + stroke + ";stroke-width:" + toStr(strokeWidth) +
+            ";stroke-opacity:" + toStr(strokeOpacity) +
             ";stroke-linejoin:round;stroke-linecap:round\"\n" };
     }
 
@@ -306,4 +405,417 @@ public:
 
         return true;
     }
+
+    // Destination of the streaming writer.
+    class Sink {
+
+    public:
+
+        virtual ~Sink() = default;
+
+        void put(const char *data, std::size_t size)
+        {
+            count += size;
+            write(data, size);
+        }
+
+        void put(std::string_view text)
+        {
+            put(text.data(), text.size());
+        }
+
+        // Parts written in order, at once where the sink allows it.
+        void put(std::span<const std::string> parts)
+        {
+            for (auto &part : parts) {
+                count += part.size();
+            }
+            gather(parts);
+        }
+
+        // Bytes received
+        [[nodiscard]] auto bytes() const -> std::size_t
+        {
+            return count;
+        }
+
+        [[nodiscard]] virtual auto ok() const -> bool
+        {
+            return true;
+        }
+
+    protected:
+
+        virtual void write(const char *data, std::size_t size) = 0;
+
+        virtual void gather(std::span<const std::string> parts)
+        {
+            for (auto &part : parts) {
+                write(part.data(), part.size());
+            }
+        }
+
+    private:
+
+        std::size_t count = 0;
+    };
+
+    // Appends to a caller-supplied buffer.
+    class MemorySink : public Sink {
+
+    public:
+
+        explicit MemorySink(std::string &text) : text(text) {}
+
+    protected:
+
+        void write(const char *data, std::size_t size) override
+        {
+            text.append(data, size);
+        }
+
+    private:
+
+        std::string &text;
+    };
+
+    class StreamSink : public Sink {
+
+    public:
+
+        explicit StreamSink(std::ostream &stream) : stream(stream) {}
+
+        [[nodiscard]] auto ok() const -> bool override
+        {
+            return stream.good();
+        }
+
+    protected:
+
+        void write(const char *data, std::size_t size) override
+        {
+            stream.write(data, static_cast<std::streamsize>(size));
+        }
+
+    private:
+
+        std::ostream &stream;
+    };
+
+    // Writes to a file descriptor through a fixed-size buffer.
+    class FileSink : public Sink {
+
+    public:
+
+        explicit FileSink(const std::string &path)
+        {
+#ifdef _WIN32
+            fd = ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+            fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+            good = fd >= 0;
+            if (!good) {
+                std::cout << "Error handling file writing.\n";
+                std::cerr << path << "\n";
+            }
+        }
+
+        FileSink(const FileSink &) = delete;
+        auto operator=(const FileSink &) -> FileSink & = delete;
+
+        ~FileSink() override
+        {
+            close();
+        }
+
+        [[nodiscard]] auto ok() const -> bool override
+        {
+            return good;
+        }
+
+        // Flushes the buffer, returns false if any write failed.
+        auto close() -> bool
+        {
+            if (fd >= 0) {
+                flush();
+#ifdef _WIN32
+                good = ::_close(fd) == 0 && good;
+#else
+                good = ::close(fd) == 0 && good;
+#endif
+                fd = -1;
+            }
+            return good;
+        }
+
+    protected:
+
+        void write(const char *data, std::size_t size) override
+        {
+            if (used + size > sizeof(buffer)) {
+                flush();
+            }
+            if (size >= sizeof(buffer)) {
+                send(data, size);
+                return;
+            }
+            std::memcpy(buffer + used, data, size);
+            used += size;
+        }
+
+#ifndef _WIN32
+        // One system call for many parts, without copying them to the buffer.
+        void gather(std::span<const std::string> parts) override
+        {
+            flush();
+            std::vector<iovec> vectors;
+            for (auto &part : parts) {
+                if (!part.empty()) {
+                    vectors.push_back({const_cast<char *>(part.data()), part.size()});
+                }
+            }
+            for (std::size_t i = 0; good && i < vectors.size(); ) {
+                auto n = ::writev(fd, vectors.data() + i,
+                                  static_cast<int>(std::min<std::size_t>(vectors.size() - i, IOV_MAX)));
+                good = n > 0;
+                // Partial write: skip the parts written, the rest of the current one goes again
+                for (auto written = good ? static_cast<std::size_t>(n) : 0; written > 0; ) {
+                    if (written < vectors[i].iov_len) {
+                        vectors[i].iov_base = static_cast<char *>(vectors[i].iov_base) + written;
+                        vectors[i].iov_len -= written;
+                        break;
+                    }
+                    written -= vectors[i++].iov_len;
+                }
+            }
+        }
+#endif
+
+    private:
+
+        int fd = -1;
+        bool good = false;
+        std::size_t used = 0;
+        char buffer[1 << 16];
+
+        void flush()
+        {
+            send(buffer, used);
+            used = 0;
+        }
+
+        void send(const char *data, std::size_t size)
+        {
+            while (good && size > 0) {
+#ifdef _WIN32
+                auto n = ::_write(fd, data, static_cast<unsigned>(size));
+#else
+                auto n = ::write(fd, data, size);
+#endif
+                good = n > 0;
+                data += good ? n : 0;
+                size -= good ? n : 0;
+            }
+        }
+    };
+
+    // Emits a document element by element, nothing is kept in memory.
+    class Writer {
+
+    public:
+
+        explicit Writer(Sink &sink, Precision precision = Precision::Full) : sink(sink), precision(precision) {}
+
+        void header(const int &width, const int &height, Metadata metadata)
+        {
+            sink.put(SVG::header(width, height, std::move(metadata)));
+        }
+
+        void footer()
+        {
+            sink.put(SVG::footer());
+        }
+
+        void beginGroup(std::string_view id, std::string_view className = {})
+        {
+            if (id.empty() && className.empty()) {
+                sink.put("<g>\n");
+                return;
+            }
+            sink.put("<g");
+            if (!id.empty()) {
+                sink.put(" id=\"");
+                sink.put(id);
+                sink.put("\"");
+            }
+            if (!className.empty()) {
+                sink.put(" class=\"");
+                sink.put(className);
+                sink.put("\"");
+            }
+            sink.put(" >\n");
+        }
+
+        void endGroup()
+        {
+            sink.put("</g>\n");
+        }
+
+        // Points : any sequence of elements with x and y.
+        template <typename Points>
+        void polyline(std::string_view name, std::string_view stroke, double strokeWidth, const Points &points)
+        {
+            if (std::empty(points)) {
+                sink.put("<!-- Empty -->\n");
+                return;
+            }
+
+            sink.put("<polyline\n");
+            style(name.empty() ? "polyline" : name, "none", stroke, strokeWidth, 255, 255);
+            sink.put("points=\"");
+            for (auto &point : points) {
+                coordinates(point.x, point.y);
+                sink.put(" ");
+            }
+            sink.put("\" />\n");
+        }
+
+        template <typename Points>
+        void polygon(std::string_view name, std::string_view fill, std::string_view stroke, double strokeWidth,
+                     const Points &points)
+        {
+            if (std::empty(points)) {
+                sink.put("<!-- Empty -->\n");
+                return;
+            }
+
+            sink.put("<path\n");
+            style(name.empty() ? "polygon" : name, fill, stroke, strokeWidth, 255, 255);
+            sink.put("d=\"M ");
+            auto first = true;
+            for (auto &point : points) {
+                if (!first) {
+                    sink.put(" L ");
+                }
+                coordinates(point.x, point.y);
+                first = false;
+            }
+            sink.put(" Z\" />\n");
+        }
+
+        void beginDefs()
+        {
+            sink.put("<defs>\n");
+        }
+
+        void endDefs()
+        {
+            sink.put("</defs>\n");
+        }
+
+        void beginStyle()
+        {
+            sink.put("<style>\n");
+        }
+
+        void endStyle()
+        {
+            sink.put("</style>\n");
+        }
+
+        // CSS class of the shapes drawn by use().
+        void styleClass(std::string_view name, std::string_view fill, std::string_view stroke, double strokeWidth)
+        {
+            sink.put(".");
+            sink.put(name);
+            sink.put("{fill:");
+            sink.put(fill.empty() ? "#FFFFFF" : fill);
+            sink.put(";stroke:");
+            sink.put(stroke.empty() ? "#000000" : stroke);
+            sink.put(";stroke-width:");
+            number(strokeWidth);
+            sink.put("}\n");
+        }
+
+        // Closed shape in its own units, inside beginDefs(). The stroke is not scaled with the shape.
+        template <typename Points>
+        void symbol(std::string_view id, const Points &points)
+        {
+            sink.put("<symbol id=\"");
+            sink.put(id);
+            sink.put("\" overflow=\"visible\">\n<path vector-effect=\"non-scaling-stroke\" "
+                     "stroke-linejoin=\"round\" stroke-linecap=\"round\" d=\"M ");
+            auto first = true;
+            for (auto &point : points) {
+                if (!first) {
+                    sink.put(" L ");
+                }
+                number(point.x);
+                sink.put(",");
+                number(point.y);
+                first = false;
+            }
+            sink.put(" Z\" />\n</symbol>\n");
+        }
+
+        // Symbol transformed by matrix(a b c d e f), painted with the CSS class or the one of its group.
+        void use(std::string_view id, std::string_view className, double a, double b, double c, double d, double e,
+                 double f)
+        {
+            sink.put("<use xlink:href=\"#");
+            sink.put(id);
+            if (!className.empty()) {
+                sink.put("\" class=\"");
+                sink.put(className);
+            }
+            sink.put("\" transform=\"matrix(");
+            // Scale and rotation with 2 decimals, under 0.01 px on a unit symbol
+            for (auto value : {a, b, c, d}) {
+                number(value, Precision::Two);
+                sink.put(" ");
+            }
+            coordinates(e, f);
+            sink.put(")\" />\n");
+        }
+
+    private:
+
+        Sink &sink;
+        Precision precision;
+        char buffer[NumberSize];
+
+        void number(double value, Precision digits = Precision::Full)
+        {
+            sink.put(buffer, format(buffer, value, digits));
+        }
+
+        void coordinates(double x, double y)
+        {
+            number(x, precision);
+            sink.put(",");
+            number(y, precision);
+        }
+
+        void style(std::string_view name, std::string_view fill, std::string_view stroke, double strokeWidth,
+                   double fillOpacity, double strokeOpacity)
+        {
+            fillOpacity   = fillOpacity < 0 ? 0 : std::min(fillOpacity / 255, 1.0);
+            strokeOpacity = strokeOpacity < 0 ? 0 : std::min(strokeOpacity / 255, 1.0);
+
+            sink.put("id=\"");
+            sink.put(name.empty() ? "Shape" : name);
+            sink.put("\"\nstyle=\"opacity:");
+            number(fillOpacity);
+            sink.put(";fill:");
+            sink.put(fill.empty() ? "#FFFFFF" : fill);
+            sink.put(";stroke:");
+            sink.put(stroke.empty() ? "#000000" : stroke);
+            sink.put(";stroke-width:");
+            number(strokeWidth);
+            sink.put(";stroke-opacity:");
+            number(strokeOpacity);
+            sink.put(";stroke-linejoin:round;stroke-linecap:round\"\n");
+        }
+    };
 };
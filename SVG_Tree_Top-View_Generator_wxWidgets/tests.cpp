@@ -0,0 +1,277 @@
+/*
+ * Checks of svgtree_core, run by ctest.
+ *
+ * Usage:
+ *
+ *      SVG_TreeTests
+ *
+ * Each check prints what differs to std::cerr, the exit code is the number of failed checks.
+ */
+
+#include "tree.h"
+#include "arena.h"
+#include "history.h"
+#include "leafKernel.h"
+#include "project.h"
+#include "spatialGrid.h"
+#include "stroke.h"
+
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+static void Check(bool condition, const std::string &message)
+{
+    if (!condition) {
+        std::cerr << message << "\n";
+        failures++;
+    }
+}
+
+// A few paths with leafs, drawn as zigzags.
+static auto Sample() -> Tree::Drawing
+{
+    Tree::Drawing drawing;
+    drawing.seed = 7;
+    drawing.generator.lineWidth = 3;
+    drawing.generator.randomColorShapeBrush = true;
+    for (unsigned i = 0; i < 4; i++) {
+        Tree::Path path(Tree::Point(50 + 100 * i, 50), i, 60, 40, 15, static_cast<unsigned>(Tree::Random(7, i)));
+        for (int j = 1; j < 60; j++) {
+            path.points.push_back(Tree::Point(50 + 100 * i + (j % 2) * 20, 50 + 6 * j));
+        }
+        drawing.paths.push_back(path);
+    }
+
+    return drawing;
+}
+
+static auto Txt(const Tree::Generator &generator, const std::vector<Tree::Path> &paths) -> std::string
+{
+    std::vector<Tree::Branch> branches;
+    generator.Update(paths, branches);
+
+    return generator.Txt(branches, 900, 500);
+}
+
+// The SSE2 and AVX2 kernels give the points of the scalar one.
+static void Kernels()
+{
+    std::mt19937 random(1);
+    std::uniform_int_distribution<int> coordinate(-100, 4000);
+    std::uniform_int_distribution<unsigned> angle(0, 720);
+    std::uniform_int_distribution<unsigned> lenght(0, 150);
+    Tree::LeafBatch batch;
+    for (int i = 0; i < 1001; i++) {
+        batch.push(Tree::Point(coordinate(random), coordinate(random)), lenght(random), angle(random));
+    }
+
+    for (unsigned shape = 0; shape < 10; shape++) {
+        auto &leaf = Tree::LeafTemplate::Get(shape);
+        std::vector<Tree::Point> expected(batch.size() * leaf.size()), points(expected.size());
+        for (std::size_t i = 0; i < batch.size(); i++) {
+            leaf.Instantiate(Tree::Point(batch.x[i], batch.y[i]), batch.lenght[i], batch.angle[i],
+                             &expected[i * leaf.size()]);
+        }
+        for (auto kernel : {Tree::Kernel::Scalar, Tree::Kernel::SSE2, Tree::Kernel::AVX2}) {
+            Tree::InstantiateBatch(leaf, batch, points.data(), kernel);
+            Check(points == expected, std::string("Kernels: ") + Tree::KernelName(kernel) + " differs, shape " +
+                  std::to_string(shape));
+        }
+    }
+}
+
+// A saved project opens with the same paths and parameters.
+static void Project()
+{
+    auto drawing = Sample();
+    auto filename = (std::filesystem::temp_directory_path() / "SVG_TreeTests.svgtree").string();
+    Check(Tree::ProjectFile::Save(filename, drawing), "Project: not saved");
+
+    Tree::Drawing loaded;
+    Check(Tree::ReadProject(filename, loaded), "Project: not read");
+    std::filesystem::remove(filename);
+    Check(loaded.width == drawing.width && loaded.height == drawing.height && loaded.seed == drawing.seed,
+          "Project: size or seed differs");
+    Check(loaded.paths.size() == drawing.paths.size(), "Project: number of paths differs");
+    for (std::size_t i = 0; i < std::min(loaded.paths.size(), drawing.paths.size()); i++) {
+        auto &a = loaded.paths[i];
+        auto &b = drawing.paths[i];
+        Check(a.points == b.points && a.shapeNumber == b.shapeNumber && a.shapeAngle == b.shapeAngle &&
+              a.shapeLenght == b.shapeLenght && a.limitLength == b.limitLength && a.seed == b.seed,
+              "Project: path " + std::to_string(i) + " differs");
+    }
+    Check(Txt(loaded.generator, loaded.paths) == Txt(drawing.generator, drawing.paths), "Project: tree differs");
+}
+
+// Undoing every edit and redoing them gives the same paths and tree.
+static void History()
+{
+    using Kind = Tree::History::Change::Kind;
+    using Field = Tree::History::Field;
+
+    auto sample = Sample();
+    auto generator = sample.generator;
+    std::vector<Tree::Path> paths;
+    Tree::History history;
+    Tree::Geometry geometry;
+
+    // Strokes, a path extended, a dragged slider, the seeds and a global parameter
+    for (auto &path : sample.paths) {
+        paths.push_back(path);
+        paths.back().points.resize(30);
+        history.Stroke(paths, paths.size() - 1, 0);
+    }
+    auto &last = paths.back().points;
+    last.insert(last.end(), sample.paths.back().points.begin() + 30, sample.paths.back().points.end());
+    history.Stroke(paths, paths.size() - 1, 30);
+    history.Set(paths, Field::Angle, 1, 70);
+    history.Set(paths, Field::Angle, 1, 80);
+    history.Reseed(paths, 42);
+    auto before = generator;
+    generator.lineWidth = 5;
+    history.SetGenerator(before, generator);
+    Check(history.Size() == 8, "History: " + std::to_string(history.Size()) + " entries instead of 8");
+
+    auto paths0 = paths;
+    auto txt = Txt(generator, paths);
+    std::size_t undos = 0;
+    while (history.CanUndo()) {
+        auto change = history.Undo(paths, generator, geometry, false);
+        Check(change.kind != Kind::None, "History: empty undo");
+        undos++;
+    }
+    Check(undos == 8 && paths.empty() && generator.lineWidth == sample.generator.lineWidth,
+          "History: not back to the start");
+    Check(history.Undo(paths, generator, geometry, false).kind == Kind::None, "History: undo past the start");
+
+    while (history.CanRedo()) {
+        history.Redo(paths, generator, geometry, false);
+    }
+    Check(paths.size() == paths0.size() && paths[1].shapeAngle == 80 && paths.back().points == paths0.back().points,
+          "History: redo does not replay the edits");
+    Check(Txt(generator, paths) == txt, "History: tree differs after undo and redo");
+
+    // A checkpoint is swapped back instead of a rebuild
+    before = generator;
+    generator.lineWidth = 9;
+    history.SetGenerator(before, generator, true);
+    Tree::Geometry old;
+    old.branches.resize(3);
+    history.Keep(std::move(old));
+    geometry.branches.resize(5);
+    auto change = history.Undo(paths, generator, geometry, true);
+    Check(change.kind == Kind::Restored && geometry.branches.size() == 3 && generator.lineWidth == 5,
+          "History: checkpoint not restored");
+
+    // Within the budget, the oldest entries are dropped
+    history.SetBudget(1024);
+    Check(history.Bytes() <= 1024 && history.Size() < 8, "History: budget not kept");
+}
+
+// A simplified stroke gives the leafs of every sample, also when continued from its branch anchor.
+static void Strokes()
+{
+    Tree::Generator generator;
+    std::mt19937 random(1);
+    std::uniform_int_distribution<int> jitter(-1, 1);
+    std::vector<Tree::Point> samples;
+    for (int i = 0; i < 400; i++) {
+        samples.push_back(Tree::Point(100 + i, 100 + i / 3 + jitter(random)));
+    }
+
+    Tree::Path every(samples.front(), 2, 60, 40, 20, 3);
+    every.points.insert(every.points.end(), samples.begin(), samples.end());
+
+    Tree::Path simplified(samples.front(), 2, 60, 40, 20, 3);
+    Tree::StrokeSimplifier simplifier(1);
+    simplifier.Begin(simplified.limitLength);
+    for (std::size_t i = 0; i < 200; i++) {
+        simplifier.Add(samples[i], simplified.points);
+    }
+    simplifier.Finish(simplified.points);
+    Tree::Branch branch;
+    generator.Update(simplified, branch);
+    simplifier.Begin(simplified, branch.anchor);
+    for (std::size_t i = 200; i < samples.size(); i++) {
+        simplifier.Add(samples[i], simplified.points);
+    }
+    simplifier.Finish(simplified.points);
+
+    Check(simplified.points.size() < every.points.size(), "Strokes: nothing simplified");
+    Tree::Branch a, b;
+    generator.Update(every, a);
+    generator.Update(simplified, b);
+    Check(a.leafs.size() == b.leafs.size() && a.placements.size() == b.placements.size(),
+          "Strokes: " + std::to_string(b.leafs.size()) + " leafs instead of " + std::to_string(a.leafs.size()));
+    for (std::size_t i = 0; i < std::min(a.placements.size(), b.placements.size()); i++) {
+        if (a.placements[i].pos != b.placements[i].pos) {
+            Check(false, "Strokes: leaf " + std::to_string(i) + " moved");
+            break;
+        }
+    }
+}
+
+// The grid finds the path under a point and every shape of a box.
+static void Grid()
+{
+    auto drawing = Sample();
+    std::vector<Tree::Branch> branches;
+    drawing.generator.Update(drawing.paths, branches);
+    Tree::SpatialGrid grid(drawing.width, drawing.height);
+    grid.build(branches);
+
+    for (std::size_t i = 0; i < drawing.paths.size(); i++) {
+        auto point = drawing.paths[i].points[10];
+        Check(grid.at(point, branches, drawing.generator.lineWidth) == static_cast<int>(i),
+              "Grid: path " + std::to_string(i) + " not found");
+    }
+    Check(grid.at(Tree::Point(880, 10), branches, drawing.generator.lineWidth) == -1, "Grid: path on empty canvas");
+
+    std::size_t shapes = 0;
+    for (auto &branch : branches) {
+        shapes += branch.leafs.size() + branch.line.points.size() - 1;
+    }
+    std::vector<Tree::SpatialGrid::Entry> entries;
+    grid.query(Tree::Box(Tree::Point(-1000, -1000), Tree::Point(2000, 2000)), entries);
+    Check(grid.size() == shapes && entries.size() == shapes, "Grid: shapes missing");
+}
+
+// Branches made in an arena are the ones made in the default memory, the arena is reused after a reset.
+static void Arenas()
+{
+    auto drawing = Sample();
+    auto arena = std::make_shared<Tree::Arena>();
+    std::vector<Tree::Branch> branches;
+    drawing.generator.Update(drawing.paths, branches, arena.get());
+    Check(arena->Used() > 0, "Arenas: nothing allocated");
+    Check(drawing.generator.Txt(branches, 900, 500) == Txt(drawing.generator, drawing.paths), "Arenas: tree differs");
+
+    auto used = arena->Used();
+    branches.clear();
+    arena->Reset();
+    Check(arena->Used() == 0 && arena->Capacity() >= used, "Arenas: not grown to the peak");
+    drawing.generator.Update(drawing.paths, branches, arena.get());
+    Check(arena->Used() == used && used <= arena->Capacity(), "Arenas: not reused");
+    branches.clear();
+}
+
+int main()
+{
+    Kernels();
+    Project();
+    History();
+    Strokes();
+    Grid();
+    Arenas();
+
+    if (failures == 0) {
+        std::cout << "All checks passed.\n";
+    }
+
+    return failures;
+}
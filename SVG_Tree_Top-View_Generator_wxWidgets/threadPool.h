@@ -0,0 +1,95 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace Tree {
+
+// Fixed number of workers consuming tasks in the order they were pushed.
+class ThreadPool {
+
+public:
+
+    explicit ThreadPool(unsigned size = std::thread::hardware_concurrency())
+    {
+        size = size == 0 ? 1 : size;
+        for (unsigned i = 0; i < size; i++) {
+            workers.emplace_back([this]() { Run(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    auto operator=(const ThreadPool &) -> ThreadPool & = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        available.notify_all();
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    }
+
+    void Push(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push(std::move(task));
+            pending++;
+        }
+        available.notify_one();
+    }
+
+    // Blocks until every pushed task has finished.
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this]() { return pending == 0; });
+    }
+
+    [[nodiscard]] auto Size() const -> unsigned
+    {
+        return workers.size();
+    }
+
+private:
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable available;
+    std::condition_variable finished;
+    unsigned pending = 0;
+    bool stop = false;
+
+    void Run()
+    {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                available.wait(lock, [this]() { return stop || !tasks.empty(); });
+                if (stop && tasks.empty()) {
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending--;
+            }
+            finished.notify_all();
+        }
+    }
+};
+
+} // namespace Tree
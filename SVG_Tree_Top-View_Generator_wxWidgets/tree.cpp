@@ -0,0 +1,705 @@
+#include "tree.h"
+#include "leafKernel.h"
+#include "profiler.h"
+#include "stroke.h"
+#include "threadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace Tree {
+
+auto Random(std::uint64_t seed, std::uint64_t index) -> std::uint64_t
+{
+    std::uint64_t z = seed + (index + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+    return z ^ (z >> 31);
+}
+
+auto angularCoordinate(unsigned lenght, unsigned angle) -> Point
+{
+    // Origin: (0,0)
+    return {static_cast<int>(Cos(0, lenght, angle)), static_cast<int>(Sin(0, lenght, angle))};
+}
+
+auto angularCoordinate(Point p, unsigned lenght, unsigned angle) -> Point
+{
+    // Origin: Point
+    return {static_cast<int>(Cos(p.x, lenght, angle)), static_cast<int>(Sin(p.y, lenght, angle))};
+}
+
+auto ShapeName(ShapeKind kind) -> const char *
+{
+    switch (kind) {
+    case ShapeKind::Polygon:
+        return "Polygon";
+    case ShapeKind::Spline:
+        return "Spline";
+    default:
+        return "Line";
+    }
+}
+
+ShapeStore::ShapeStore(std::pmr::memory_resource *memory)
+    : vertices(memory), offsets(1, 0, memory), kinds(memory), penIndices(memory), brushIndices(memory),
+      lineWidths(memory), boxes(memory), pens(memory), brushes(memory)
+{
+}
+
+void ShapeStore::clear()
+{
+    vertices.clear();
+    offsets.resize(1);
+    kinds.clear();
+    penIndices.clear();
+    brushIndices.clear();
+    lineWidths.clear();
+    boxes.clear();
+    pens.clear();
+    brushes.clear();
+}
+
+void ShapeStore::reserve(std::size_t shapes, std::size_t vertices)
+{
+    this->vertices.reserve(vertices);
+    offsets.reserve(shapes + 1);
+    kinds.reserve(shapes);
+    penIndices.reserve(shapes);
+    brushIndices.reserve(shapes);
+    lineWidths.reserve(shapes);
+    boxes.reserve(shapes);
+}
+
+auto ShapeStore::Index(std::pmr::vector<Colour> &palette, Colour colour) -> unsigned
+{
+    // Leafs of a branch share a few colours, only the last ones are searched
+    constexpr std::size_t recent = 8;
+    auto first = palette.size() > recent ? palette.end() - recent : palette.begin();
+    auto found = std::find(first, palette.end(), colour);
+    if (found == palette.end()) {
+        palette.push_back(colour);
+        return palette.size() - 1;
+    }
+
+    return found - palette.begin();
+}
+
+auto ShapeStore::add(ShapeKind kind, unsigned pen, unsigned brush, unsigned lineWidth,
+                     std::size_t vertices) -> std::size_t
+{
+    this->vertices.resize(this->vertices.size() + vertices);
+    offsets.push_back(this->vertices.size());
+    kinds.push_back(kind);
+    penIndices.push_back(pen);
+    brushIndices.push_back(brush);
+    lineWidths.push_back(lineWidth);
+    boxes.push_back(Box());
+
+    return kinds.size() - 1;
+}
+
+void ShapeStore::bound(std::size_t first)
+{
+    for (std::size_t i = first; i < size(); i++) {
+        Box box;
+        for (auto &point : points(i)) {
+            box.add(point);
+        }
+        boxes[i] = box;
+    }
+}
+
+auto ShapeStore::memory() const -> std::size_t
+{
+    return vertices.capacity() * sizeof(Point) + offsets.capacity() * sizeof(unsigned) +
+           kinds.capacity() * sizeof(ShapeKind) + (penIndices.capacity() + brushIndices.capacity()) * sizeof(unsigned) +
+           lineWidths.capacity() * sizeof(unsigned short) + boxes.capacity() * sizeof(Box) + (pens.capacity() + brushes.capacity()) * sizeof(Colour);
+}
+
+LeafTemplate::LeafTemplate(std::vector<Vertex> vertices) : vertices(std::move(vertices))
+{
+    for (auto &vertex : this->vertices) {
+        x.push_back(vertex.radius * CosTable[DegreeIndex(vertex.angle)]);
+        y.push_back(vertex.radius * SinTable[DegreeIndex(vertex.angle)]);
+    }
+}
+
+void LeafTemplate::Instantiate(Point pos, unsigned lenght, unsigned angle, Point *points) const
+{
+    InstantiateLeaf(*this, pos, lenght, angle, points);
+}
+
+auto LeafTemplate::All() -> std::vector<LeafTemplate> &
+{
+    // Custom images similar to leaf buttons, 0 and 1 are simple lines
+    static std::vector<LeafTemplate> leafs = {
+        {{{0, 0}, {1, 0}}},
+        {{{0, 0}, {1, 0}}},
+        {{{0, 0}, {1. / 2, 15}, {1, 0}, {1. / 2, -15}, {0, 0}}},
+        {{{0, 0}, {2. / 5, 45}, {1, 0}, {2. / 5, -45}, {0, 0}}},
+        {{{0, 0}, {2. / 6, 60}, {4. / 6, 20}, {1, 0}, {4. / 6, -20}, {2. / 6, -60}, {0, 0}}},
+        {{{0, 0}, {1, 15}, {3. / 5, 0}, {1, -15}, {0, 0}}},
+        {{{0, 0}, {1, 20}, {1. / 5, 0}, {1, 15}, {2. / 5, 0}, {1, 5}, {3. / 5, 0},
+          {1, -5}, {2. / 5, 0}, {1, -15}, {1. / 5, 0}, {1, -20}, {0, 0}}},
+        {{{0, 0}, {1, 45}, {2. / 6, 0}, {1, 30}, {3. / 6, 0}, {1, 10}, {4. / 6, 0},
+          {1, -10}, {3. / 6, 0}, {1, -30}, {2. / 6, 0}, {1, -45}, {0, 0}}},
+        {{{0, 0}, {1. / 2, 70}, {1. / 2, 50}, {1. / 2, 10}, {1. / 2, -10}, {1. / 2, -50}, {1. / 2, -70}, {0, 0}}},
+        {{{0, 0}, {1, 20}, {1, 5}, {1, -20}, {0, 0}}},
+        {{{0, 0}, {1, 60}, {2. / 5, -45}, {0, 0}, {2. / 5, 45}, {1, -60}, {0, 0}}}
+    };
+    return leafs;
+}
+
+auto LeafTemplate::Get(unsigned shape) -> const LeafTemplate &
+{
+    auto &leafs = All();
+    return shape < leafs.size() ? leafs[shape] : leafs.front();
+}
+
+auto LeafTemplate::Load(const std::string &filename) -> bool
+{
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::vector<std::pair<unsigned, LeafTemplate>> loaded;
+    std::string line;
+    unsigned number = 0;
+    while (std::getline(file, line)) {
+        number++;
+        std::istringstream values(line);
+        unsigned shape = 0;
+        std::string token;
+        if (!(values >> token) || token[0] == '#') {
+            continue;
+        }
+
+        std::vector<Vertex> vertices;
+        auto ok = static_cast<bool>(std::istringstream(token) >> shape);
+        while (ok && values >> token) {
+            Vertex vertex;
+            char comma = 0;
+            std::istringstream pair(token);
+            ok = pair >> vertex.radius >> comma >> vertex.angle && comma == ',';
+            vertices.push_back(vertex);
+        }
+        if (!ok || vertices.size() < 2) {
+            std::cerr << filename << ":" << number << ": invalid leaf.\n";
+            return false;
+        }
+        loaded.push_back({shape, LeafTemplate(vertices)});
+    }
+
+    // Replaces or adds shapes only if the whole file is valid
+    auto &leafs = All();
+    for (auto &[shape, leaf] : loaded) {
+        if (shape >= leafs.size()) {
+            leafs.resize(shape + 1, leafs.front());
+        }
+        leafs[shape] = leaf;
+    }
+
+    return true;
+}
+
+// One branch for each path, new ones in the memory resource if given.
+static void Allocate(const std::vector<Path> &paths, std::vector<Branch> &branches, std::pmr::memory_resource *memory)
+{
+    if (memory) {
+        branches.clear();
+        branches.reserve(paths.size());
+        for (std::size_t i = 0; i < paths.size(); i++) {
+            branches.emplace_back(memory);
+        }
+    }
+    branches.resize(paths.size());
+}
+
+auto Generator::Update(const std::vector<Path> &paths, std::vector<Branch> &branches,
+                       std::pmr::memory_resource *memory) const -> unsigned
+{
+    unsigned count = 0;
+    Allocate(paths, branches, memory);
+    for (unsigned i = 0; i < paths.size(); i++) {
+        count += Update(paths[i], branches[i]);
+    }
+
+    return count;
+}
+
+auto Generator::Update(const std::vector<Path> &paths, std::vector<Branch> &branches, ThreadPool &pool,
+                       std::stop_token stop, std::pmr::memory_resource *memory) const -> unsigned
+{
+    // Each task writes only its own branches, so the result and its order are the same as the serial update
+    constexpr std::size_t taskPoints = 4096;
+    std::atomic<unsigned> count = 0;
+    Allocate(paths, branches, memory);
+    for (std::size_t begin = 0, end = 0; begin < paths.size(); begin = end) {
+        std::size_t points = 0;
+        while (end < paths.size() && (end == begin || points < taskPoints)) {
+            points += paths[end++].points.size();
+        }
+        pool.Push([&, begin, end]() {
+            unsigned shapes = 0;
+            for (auto i = begin; i < end && !stop.stop_requested(); i++) {
+                shapes += Update(paths[i], branches[i]);
+            }
+            count += shapes;
+        });
+    }
+    pool.Wait();
+
+    return count;
+}
+
+// Leafs of a whole path, walked as Generator::Update does.
+static auto LeafCount(const Path &line) -> std::size_t
+{
+    if (line.limitLength == 0 || line.points.size() < 2) {
+        return 0;
+    }
+    std::size_t count = 0;
+    auto anchor = line.points[1];
+    for (std::size_t i = 2; i < line.points.size(); i++) {
+        auto &point = line.points[i];
+        auto distance = Distance(point.x, point.y, anchor.x, anchor.y);
+        if (distance > line.limitLength) {
+            count += 2 * static_cast<unsigned>(distance / line.limitLength);
+            anchor = point;
+        }
+    }
+
+    return count;
+}
+
+auto Generator::Update(const Path &line, Branch &branch, bool incremental) const -> unsigned
+{
+    unsigned count = 0;
+    if (!incremental) {
+        branch.leafs.clear();
+        branch.shape = line.shapeNumber;
+        branch.placements.clear();
+        branch.line.kind = ShapeKind::Line;
+        branch.line.pen = colorLinePen;
+        branch.line.brush = colorLineBrush;
+        branch.line.lineWidth = lineWidth;
+        branch.line.points.clear();
+        branch.next = 1;
+        branch.bounds = Box();
+    }
+
+    // Leafs
+    if (line.shapeLenght == 0) {    // transparent leaf
+        return count;
+    }
+    // Only the points added since the last update are checked, the branch is walked from its first point
+    auto &leaf = LeafTemplate::Get(line.shapeNumber);
+    auto &leafs = branch.leafs;
+    if (!incremental) {
+        // At once: buffers grown by steps would leave their old copies in an arena
+        auto shapes = LeafCount(line);
+        leafs.reserve(shapes, shapes * leaf.size());
+        branch.placements.reserve(shapes);
+        branch.line.points.reserve(line.points.size());
+    }
+    auto kind = isSpline ? ShapeKind::Spline : ShapeKind::Polygon;
+    auto pen = leafs.penIndex(colorShapePen);
+    auto brush = randomColorShapeBrush ? 0 : leafs.brushIndex(colorShapeBrush);
+    auto first = leafs.size();
+    auto linePoints = branch.line.points.size();
+    thread_local LeafBatch batch;
+    batch.clear();
+    for (; branch.next < line.points.size(); branch.next++) {
+        auto &currentPoint = line.points[branch.next];
+        if (branch.next == 1) {
+            branch.anchor = currentPoint;
+        }
+        auto distance = Distance(currentPoint.x, currentPoint.y, branch.anchor.x, branch.anchor.y);
+        if (distance > line.limitLength && line.limitLength > 0) { // distance greater than expected range
+            // Segment angle, leafs point to the end of the branch
+            auto lineAngle = LineAngle(currentPoint.x, currentPoint.y, branch.anchor.x, branch.anchor.y);
+            // Number of intermediate points in the segment
+            unsigned num = distance / line.limitLength;
+            for (unsigned j = 0; j < num; j++) {  // build intermediate points if necessary
+                // Fill color, the same for the same path seed and leaf index
+                if (randomColorShapeBrush) {
+                    auto random = Random(line.seed, leafs.size());
+                    unsigned r = maxColorShapeBrush.red - minColorShapeBrush.red;
+                    unsigned g = maxColorShapeBrush.green - minColorShapeBrush.green;
+                    unsigned b = maxColorShapeBrush.blue - minColorShapeBrush.blue;
+                    r = r > 0 ? (random & 0xFFFF) % r : 0;
+                    g = g > 0 ? ((random >> 16) & 0xFFFF) % g : 0;
+                    b = b > 0 ? ((random >> 32) & 0xFFFF) % b : 0;
+                    brush = leafs.brushIndex(Colour((minColorShapeBrush.red + r) % 255,
+                                                    (minColorShapeBrush.green + g) % 255,
+                                                    (minColorShapeBrush.blue + b) % 255));
+                }
+                // Current leafs
+                Point point = currentPoint - angularCoordinate(j * line.limitLength, lineAngle);
+                for (auto &signal : {-1, 1}) {
+                    auto angle = lineAngle + signal * line.shapeAngle;
+                    auto pos = point + angularCoordinate(lineWidth, angle);
+                    // Save structure
+                    leafs.add(kind, pen, brush, 1, leaf.size());
+                    batch.push(pos, line.shapeLenght, angle);
+                    branch.placements.push_back({pos, line.shapeLenght, angle});
+                    count++;
+                }
+            }
+            // Next segment
+            branch.anchor = currentPoint;
+        }
+        // Branch points
+        branch.line.points.push_back(currentPoint);
+        branch.bounds.add(currentPoint);
+    }
+
+    // Leaf points of this update, all at once and in place
+    if (!batch.empty()) {
+        InstantiateBatch(leaf, batch, leafs.data(first));
+        leafs.bound(first);
+        for (auto i = first; i < leafs.size(); i++) {
+            branch.bounds.add(leafs.bounds(i));
+        }
+    }
+    Profiler::Add(Profiler::Counter::Shapes, count + 1);
+    Profiler::Add(Profiler::Counter::Vertices, count * leaf.size() + branch.line.points.size() - linePoints);
+
+    return count + 1;   // current branch
+}
+
+auto Generator::IsVisible(const Branch &branch) const -> bool
+{
+    return branch.line.points.size() > 1 && lineWidth > 0;
+}
+
+auto Generator::GetPoints(unsigned shape, Point pos, unsigned lenght, unsigned angle) -> std::vector<Point>
+{
+    // Custom images similar to leaf buttons
+    auto &leaf = LeafTemplate::Get(shape);
+    std::vector<Point> points(leaf.size());
+    leaf.Instantiate(pos, lenght, angle, points.data());
+
+    return points;
+}
+
+// Colour pair of a leaf, key of its class.
+static auto ClassKey(Colour pen, Colour brush) -> std::uint64_t
+{
+    return static_cast<std::uint64_t>(pen.red) << 40 | static_cast<std::uint64_t>(pen.green) << 32 |
+           static_cast<std::uint64_t>(pen.blue) << 24 | brush.red << 16 | brush.green << 8 | brush.blue;
+}
+
+auto Generator::SvgNames(const Branch &branch) const -> unsigned
+{
+    auto visible = IsVisible(branch);
+
+    return branch.leafs.size() + (visible ? 1 : 0) + (visible && !branch.leafs.empty() ? 2 : 0);
+}
+
+void Generator::SvgBranches(SVG::Writer &writer, const std::vector<Branch> &branches, std::size_t begin,
+                            std::size_t end, unsigned number, const SvgClasses *classes) const
+{
+    // Names are numbered in the order the shapes are generated, groups after their content.
+    unsigned count = number;
+    std::string name, className, symbol, pen, brush;
+    auto id = [](std::string & text, const char *prefix, unsigned number) -> const std::string & {
+        text = prefix;
+        text += std::to_string(number);
+        return text;
+    };
+    auto classOf = [&](const ShapeStore & leafs, std::size_t i) -> const std::string & {
+        return id(className, "c", classes->find(ClassKey(leafs.pen(i), leafs.brush(i)))->second);
+    };
+
+    for (auto b = begin; b < end; b++) {
+        auto &branch = branches[b];
+        auto &leafs = branch.leafs;
+        auto visible = IsVisible(branch);
+        auto grouped = visible && !leafs.empty();
+        unsigned line = count + leafs.size();
+        // One colour for the whole branch: the class goes to the group
+        auto uniform = grouped && classes;
+        for (std::size_t i = 1; uniform && i < leafs.size(); i++) {
+            uniform = ClassKey(leafs.pen(i), leafs.brush(i)) == ClassKey(leafs.pen(0), leafs.brush(0));
+        }
+        if (grouped) {
+            writer.beginGroup(id(name, "Branch", line + 2));
+            writer.beginGroup(id(name, "Leafs", line + 1), uniform ? classOf(leafs, 0) : "");
+        }
+        if (classes) {
+            id(symbol, "leaf", branch.shape);
+            for (std::size_t i = 0; i < leafs.size(); i++, count++) {
+                // Same rotation and scale as InstantiateLeaf
+                auto &placement = branch.placements[i];
+                double c = placement.lenght * CosTable[DegreeIndex(placement.angle)];
+                double s = placement.lenght * SinTable[DegreeIndex(placement.angle)];
+                writer.use(symbol, uniform ? "" : classOf(leafs, i), c, s, -s, c, placement.pos.x, placement.pos.y);
+            }
+        }
+        else {
+            for (std::size_t i = 0; i < leafs.size(); i++) {
+                pen = leafs.pen(i).toHex();
+                brush = leafs.brush(i).toHex();
+                writer.polygon(id(name, ShapeName(leafs.kind(i)), count++), brush, pen, leafs.lineWidth(i),
+                               leafs.points(i));
+            }
+        }
+        if (grouped) {
+            writer.endGroup();
+        }
+        if (visible) {
+            pen = branch.line.pen.toHex();
+            writer.polyline(id(name, ShapeName(branch.line.kind), count++), pen, branch.line.lineWidth,
+                            branch.line.points);
+            count += grouped ? 2 : 0;
+        }
+        if (grouped) {
+            writer.endGroup();
+        }
+    }
+}
+
+auto Generator::SvgDefs(SVG::Writer &writer, const std::vector<Branch> &branches) const -> SvgClasses
+{
+    // Templates and colour pairs in use, classes are numbered in order of appearance
+    std::vector<bool> templates;
+    SvgClasses classes;
+    std::vector<std::pair<std::size_t, std::size_t>> first;     // branch and leaf of each class
+    for (std::size_t b = 0; b < branches.size(); b++) {
+        auto &leafs = branches[b].leafs;
+        if (leafs.empty()) {
+            continue;
+        }
+        templates.resize(std::max<std::size_t>(templates.size(), branches[b].shape + 1));
+        templates[branches[b].shape] = true;
+        for (std::size_t i = 0; i < leafs.size(); i++) {
+            if (classes.try_emplace(ClassKey(leafs.pen(i), leafs.brush(i)), classes.size()).second) {
+                first.emplace_back(b, i);
+            }
+        }
+    }
+
+    writer.beginDefs();
+    writer.beginStyle();
+    for (unsigned c = 0; c < first.size(); c++) {
+        auto &leafs = branches[first[c].first].leafs;
+        auto i = first[c].second;
+        writer.styleClass("c" + std::to_string(c), leafs.brush(i).toHex(), leafs.pen(i).toHex(), leafs.lineWidth(i));
+    }
+    writer.endStyle();
+    std::vector<SVG::Point> unit;
+    for (unsigned shape = 0; shape < templates.size(); shape++) {
+        if (templates[shape]) {
+            auto &leaf = LeafTemplate::Get(shape);
+            unit.clear();
+            for (std::size_t k = 0; k < leaf.size(); k++) {
+                unit.push_back(SVG::Point(leaf.UnitX()[k], leaf.UnitY()[k]));
+            }
+            writer.symbol("leaf" + std::to_string(shape), unit);
+        }
+    }
+    writer.endDefs();
+
+    return classes;
+}
+
+void Generator::Svg(SVG::Writer &writer, const std::vector<Branch> &branches, int width, int height,
+                    const SVG::Metadata &metadata) const
+{
+    writer.header(width, height, metadata);
+    SvgBranches(writer, branches, 0, branches.size(), 0);
+    writer.footer();
+}
+
+void Generator::SvgSymbols(SVG::Writer &writer, const std::vector<Branch> &branches, int width, int height,
+                           const SVG::Metadata &metadata) const
+{
+    writer.header(width, height, metadata);
+    auto classes = SvgDefs(writer, branches);
+    SvgBranches(writer, branches, 0, branches.size(), 0, &classes);
+    writer.footer();
+}
+
+auto Generator::Svg(const std::vector<Branch> &branches, int width, int height,
+                    const SVG::Metadata &metadata) const -> std::string
+{
+    std::string svg;
+    SVG::MemorySink sink(svg);
+    SVG::Writer writer(sink);
+    Svg(writer, branches, width, height, metadata);
+
+    return svg;
+}
+
+auto Generator::Txt(const std::vector<Branch> &branches, int width, int height) const -> std::string
+{
+    std::string delim = "\t";
+    std::string txt = "Drawing Area" + delim + std::to_string(width) + " x " + std::to_string(height) + "\n";
+    txt += "Name" + delim + "Stroke" + delim + "Fill" + delim + "Stroke width" + delim + "Points\n";
+    auto write = [&](ShapeKind kind, Colour pen, Colour brush, unsigned lineWidth, std::span<const Point> points) {
+        txt += ShapeName(kind) + delim;
+        txt += pen.toHex() + delim;
+        txt += brush.toHex() + delim;
+        txt += std::to_string(lineWidth) + delim;
+        for (auto &point : points) {
+            txt += std::to_string(point.x) + "," + std::to_string(point.y) + delim;
+        }
+        txt += "\n";
+    };
+    for (auto &branch : branches) {
+        auto &leafs = branch.leafs;
+        for (std::size_t i = 0; i < leafs.size(); i++) {
+            write(leafs.kind(i), leafs.pen(i), leafs.brush(i), leafs.lineWidth(i), leafs.points(i));
+        }
+        if (IsVisible(branch)) {
+            auto &line = branch.line;
+            write(line.kind, line.pen, line.brush, line.lineWidth, line.points);
+        }
+    }
+
+    return txt;
+}
+
+Drawing::Drawing()
+{
+    // Same as the initial values of the app
+    generator.colorShapePen = Colour(0, 102, 0);
+    generator.colorShapeBrush = Colour(50, 200, 50);
+    generator.colorLinePen = Colour(130, 60, 0);
+    generator.colorLineBrush = Colour(130, 60, 0);
+    generator.lineWidth = 2;
+}
+
+auto ReadDrawing(const std::string &filename, Drawing &drawing) -> bool
+{
+    auto hex2RGB = [](const std::string & value, Colour & colour) {
+        if (value.size() != 7 || value[0] != '#') {
+            return false;
+        }
+        try {
+            auto rgb = std::stoul(value.substr(1), nullptr, 16);
+            colour = Colour((rgb >> 16) & 0xFF, (rgb >> 8) & 0xFF, rgb & 0xFF);
+        }
+        catch (...) {
+            return false;
+        }
+        return true;
+    };
+
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error handling file reading: " << filename << "\n";
+        return false;
+    }
+
+    std::string line;
+    unsigned number = 0;
+    double tolerance = 0;
+    std::vector<double> tolerances;     // of each path
+    while (std::getline(file, line)) {
+        number++;
+        std::istringstream values(line);
+        std::string key;
+        if (!(values >> key) || key[0] == '#') {
+            continue;
+        }
+
+        auto ok = true;
+        auto &generator = drawing.generator;
+        if (key == "size") {
+            ok = static_cast<bool>(values >> drawing.width >> drawing.height);
+        }
+        else if (key == "lineWidth") {
+            ok = static_cast<bool>(values >> generator.lineWidth);
+        }
+        else if (key == "spline") {
+            ok = static_cast<bool>(values >> generator.isSpline);
+        }
+        else if (key == "leafPen" || key == "leafBrush" || key == "branch") {
+            std::string value;
+            Colour colour;
+            ok = values >> value && hex2RGB(value, colour);
+            if (key == "leafPen") {
+                generator.colorShapePen = colour;
+            }
+            else if (key == "leafBrush") {
+                generator.colorShapeBrush = colour;
+            }
+            else {
+                generator.colorLinePen = colour;
+                generator.colorLineBrush = colour;
+            }
+        }
+        else if (key == "random") {
+            std::string value1, value2;
+            Colour color1, color2;
+            ok = values >> value1 >> value2 && hex2RGB(value1, color1) && hex2RGB(value2, color2);
+            generator.minColorShapeBrush = Colour(std::min(color1.red, color2.red),
+                                                  std::min(color1.green, color2.green),
+                                                  std::min(color1.blue, color2.blue));
+            generator.maxColorShapeBrush = Colour(std::max(color1.red, color2.red),
+                                                  std::max(color1.green, color2.green),
+                                                  std::max(color1.blue, color2.blue));
+            generator.randomColorShapeBrush = !(color1 == color2);
+        }
+        else if (key == "seed") {
+            ok = static_cast<bool>(values >> drawing.seed);
+        }
+        else if (key == "simplify") {
+            ok = values >> tolerance && tolerance >= 0;
+        }
+        else if (key == "path") {
+            Path path;
+            path.seed = static_cast<unsigned>(Random(drawing.seed, drawing.paths.size()));
+            ok = static_cast<bool>(values >> path.shapeNumber >> path.shapeAngle >> path.shapeLenght >> path.limitLength);
+            if (ok && !(values >> path.seed)) {
+                ok = values.eof();
+            }
+            drawing.paths.push_back(path);
+            tolerances.push_back(tolerance);
+        }
+        else {
+            // Points of the last path
+            if (drawing.paths.empty()) {
+                ok = false;
+            }
+            for (auto token = key; ok; ) {
+                Point point;
+                char comma = 0;
+                std::istringstream coordinates(token);
+                ok = coordinates >> point.x >> comma >> point.y && comma == ',';
+                if (ok) {
+                    auto &points = drawing.paths.back().points;
+                    if (points.empty()) {
+                        points.push_back(point);    // first point is repeated, as in the app
+                    }
+                    points.push_back(point);
+                }
+                if (!(values >> token)) {
+                    break;
+                }
+            }
+        }
+
+        if (!ok) {
+            std::cerr << filename << ":" << number << ": invalid line.\n";
+            return false;
+        }
+    }
+
+    for (std::size_t i = 0; i < drawing.paths.size(); i++) {
+        Simplify(drawing.paths[i], tolerances[i]);
+    }
+
+    return true;
+}
+
+} // namespace Tree
@@ -0,0 +1,327 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "svg.h"    // geometry helpers
+
+/*
+ * Tree generation without wxWidgets.
+ *
+ * Shared by the drawing app and by the headless tools.
+ */
+namespace Tree {
+
+class ThreadPool;
+
+struct Point {
+    int x = 0;
+    int y = 0;
+
+    Point() = default;
+    Point(int x, int y) : x(x), y(y) {}
+
+    auto operator+(const Point &other) const -> Point { return {x + other.x, y + other.y}; }
+    auto operator-(const Point &other) const -> Point { return {x - other.x, y - other.y}; }
+    auto operator==(const Point &other) const -> bool = default;
+};
+
+// Axis-aligned bounding box, empty until a point is added.
+struct Box {
+    Point min = Point(INT_MAX, INT_MAX);
+    Point max = Point(INT_MIN, INT_MIN);
+
+    Box() = default;
+    Box(Point min, Point max) : min(min), max(max) {}
+
+    [[nodiscard]] auto empty() const -> bool { return min.x > max.x || min.y > max.y; }
+
+    void add(Point point)
+    {
+        min = Point(std::min(min.x, point.x), std::min(min.y, point.y));
+        max = Point(std::max(max.x, point.x), std::max(max.y, point.y));
+    }
+
+    void add(const Box &other)
+    {
+        if (!other.empty()) {
+            add(other.min);
+            add(other.max);
+        }
+    }
+
+    [[nodiscard]] auto intersects(const Box &other) const -> bool
+    {
+        return min.x <= other.max.x && other.min.x <= max.x && min.y <= other.max.y && other.min.y <= max.y;
+    }
+};
+
+struct Colour {
+    unsigned char red = 0;
+    unsigned char green = 0;
+    unsigned char blue = 0;
+    unsigned char alpha = 255;
+
+    Colour() = default;
+    Colour(unsigned char red, unsigned char green, unsigned char blue, unsigned char alpha = 255)
+        : red(red), green(green), blue(blue), alpha(alpha) {}
+
+    auto operator==(const Colour &other) const -> bool = default;
+
+    [[nodiscard]] auto toHex() const -> std::string
+    {
+        return SVG::RGB2HEX(red, green, blue);
+    }
+};
+
+enum class ShapeKind : unsigned char { Line, Polygon, Spline };
+
+// Name used in the exported files.
+auto ShapeName(ShapeKind kind) -> const char *;
+
+struct Shape {
+    ShapeKind kind = ShapeKind::Line;
+    Colour pen = Colour(0, 0, 0, 255);
+    Colour brush = Colour(255, 255, 255, 255);
+    unsigned lineWidth = 1;
+    std::pmr::vector<Point> points;
+
+    Shape() = default;
+    explicit Shape(std::pmr::memory_resource *memory) : points(memory) {}
+};
+
+/*
+ * Shapes in structure-of-arrays form.
+ *
+ * The vertices of all shapes are kept in one buffer, shape i uses vertices [offset i, offset i+1).
+ * Colours are indices in a pen and a brush palette. clear() keeps the capacity for the next rebuild.
+ * The buffers come from the memory resource given at construction, copies use the default one.
+ */
+class ShapeStore {
+public:
+    ShapeStore() = default;
+    explicit ShapeStore(std::pmr::memory_resource *memory);
+
+    void clear();
+    void reserve(std::size_t shapes, std::size_t vertices);
+
+    [[nodiscard]] auto size() const -> std::size_t { return kinds.size(); }
+    [[nodiscard]] auto empty() const -> bool { return kinds.empty(); }
+
+    // Palette indices, recent colours are reused.
+    auto penIndex(Colour colour) -> unsigned { return Index(pens, colour); }
+    auto brushIndex(Colour colour) -> unsigned { return Index(brushes, colour); }
+
+    // Adds a shape of uninitialized vertices, returns its index.
+    auto add(ShapeKind kind, unsigned pen, unsigned brush, unsigned lineWidth, std::size_t vertices) -> std::size_t;
+
+    // Vertices from the shape i on, to be written after add().
+    auto data(std::size_t i) -> Point * { return vertices.data() + offsets[i]; }
+
+    // Bounding boxes of the shapes from first on, once their vertices are written.
+    void bound(std::size_t first);
+
+    [[nodiscard]] auto kind(std::size_t i) const -> ShapeKind { return kinds[i]; }
+    [[nodiscard]] auto pen(std::size_t i) const -> Colour { return pens[penIndices[i]]; }
+    [[nodiscard]] auto brush(std::size_t i) const -> Colour { return brushes[brushIndices[i]]; }
+    [[nodiscard]] auto lineWidth(std::size_t i) const -> unsigned { return lineWidths[i]; }
+    [[nodiscard]] auto bounds(std::size_t i) const -> const Box & { return boxes[i]; }
+    [[nodiscard]] auto points(std::size_t i) const -> std::span<const Point>
+    {
+        return {vertices.data() + offsets[i], vertices.data() + offsets[i + 1]};
+    }
+
+    // Bytes in use, capacity included.
+    [[nodiscard]] auto memory() const -> std::size_t;
+
+private:
+    std::pmr::vector<Point> vertices;
+    std::pmr::vector<unsigned> offsets = {0};
+    std::pmr::vector<ShapeKind> kinds;
+    std::pmr::vector<unsigned> penIndices, brushIndices;
+    std::pmr::vector<unsigned short> lineWidths;
+    std::pmr::vector<Box> boxes;
+    std::pmr::vector<Colour> pens, brushes;
+
+    static auto Index(std::pmr::vector<Colour> &palette, Colour colour) -> unsigned;
+};
+
+// Stroke drawn by the user and the parameters of its leafs.
+struct Path {
+    unsigned limitLength = 0;
+    unsigned shapeAngle = 0;
+    unsigned shapeLenght = 0;
+    unsigned shapeNumber = 0;
+    unsigned seed = 0;      // random leaf colours
+    std::vector<Point> points;
+
+    Path() = default;
+    Path(Point point, unsigned shapeNumber = 0, unsigned shapeAngle = 0, unsigned shapeLenght = 0,
+         unsigned limitLength = 0, unsigned seed = 0)
+        : limitLength(limitLength), shapeAngle(shapeAngle), shapeLenght(shapeLenght), shapeNumber(shapeNumber),
+          seed(seed), points({point}) {}
+};
+
+// Leaf as its template moved, scaled and rotated: the points are LeafTemplate::Instantiate of these.
+struct Placement {
+    Point pos;
+    unsigned lenght = 0;
+    unsigned angle = 0;
+};
+
+// Shapes generated from a Path, extended in place while the branch grows.
+struct Branch {
+    ShapeStore leafs;
+    unsigned shape = 0;                     // leaf template
+    std::pmr::vector<Placement> placements; // of each leaf
+    Shape line;
+    unsigned next = 1;  // next branch point to be checked
+    Point anchor;       // last branch point that received leafs
+    Box bounds;         // leafs and line points, without the line width
+
+    Branch() = default;
+    // Geometry in the memory of a rebuild, see Arena.
+    explicit Branch(std::pmr::memory_resource *memory) : leafs(memory), placements(memory), line(memory) {}
+};
+
+/*
+ * Leaf shape as a list of vertices in polar coordinates relative to the leaf.
+ *
+ * A leaf is the template rotated by the leaf angle, scaled by its length and moved to its position.
+ * Shapes may be replaced or added from a file, one shape per line:
+ *
+ *      # shapeNumber radius,angle radius,angle ...
+ *      11 0,0 1,30 0.5,0 1,-30 0,0
+ */
+class LeafTemplate {
+public:
+    struct Vertex {
+        double radius = 0;  // fraction of the leaf length
+        int angle = 0;      // degrees from the leaf angle
+    };
+
+    LeafTemplate(std::vector<Vertex> vertices);
+
+    [[nodiscard]] auto size() const -> std::size_t { return x.size(); }
+
+    // Unit vertices, length 1 and angle 0.
+    [[nodiscard]] auto UnitX() const -> const double * { return x.data(); }
+    [[nodiscard]] auto UnitY() const -> const double * { return y.data(); }
+
+    // Writes size() points.
+    void Instantiate(Point pos, unsigned lenght, unsigned angle, Point *points) const;
+
+    // Unknown shapes are simple lines.
+    static auto Get(unsigned shape) -> const LeafTemplate &;
+
+    // Must be called before generating leafs in other threads.
+    static auto Load(const std::string &filename) -> bool;
+
+private:
+    std::vector<Vertex> vertices;
+    std::vector<double> x, y;
+
+    static auto All() -> std::vector<LeafTemplate> &;
+};
+
+// Colour classes of the leafs in SvgSymbols, by pen and brush.
+using SvgClasses = std::unordered_map<std::uint64_t, unsigned>;
+
+class Generator {
+public:
+    // Global parameters, a change requires a full rebuild.
+    Colour colorLineBrush = Colour(0, 0, 0, 255);
+    Colour colorLinePen = Colour(0, 0, 0, 255);
+    Colour colorShapeBrush = Colour(0, 0, 0, 255);
+    Colour colorShapePen = Colour(0, 0, 0, 255);
+    Colour minColorShapeBrush = colorShapeBrush;
+    Colour maxColorShapeBrush = colorShapeBrush;
+    bool randomColorShapeBrush = false;     // colour of each leaf pair from the path seed and the leaf index
+    bool isSpline = false;
+    unsigned lineWidth = 10;
+
+    // Rebuilds all branches, returns the number of generated shapes.
+    // With a memory resource the branches are made again in it, else their buffers are reused.
+    auto Update(const std::vector<Path> &paths, std::vector<Branch> &branches,
+                std::pmr::memory_resource *memory = nullptr) const -> unsigned;
+
+    // Same branches, groups of branches are generated by the pool. Not to be called from a task of the same pool.
+    // Once a stop is requested the remaining branches are left as they are.
+    auto Update(const std::vector<Path> &paths, std::vector<Branch> &branches, ThreadPool &pool,
+                std::stop_token stop = {}, std::pmr::memory_resource *memory = nullptr) const -> unsigned;
+
+    // Rebuilds one branch or only checks the points added since the last update.
+    auto Update(const Path &line, Branch &branch, bool incremental = false) const -> unsigned;
+
+    // True if the branch line is part of the drawing.
+    [[nodiscard]] auto IsVisible(const Branch &branch) const -> bool;
+
+    // SVG document of the generated branches, leafs are grouped by branch.
+    void Svg(SVG::Writer &writer, const std::vector<Branch> &branches, int width, int height,
+             const SVG::Metadata &metadata) const;
+    auto Svg(const std::vector<Branch> &branches, int width, int height,
+             const SVG::Metadata &metadata) const -> std::string;
+
+    // Same document with each leaf template once as a <symbol> and each leaf as a transformed <use>.
+    // Colours are CSS classes. Smaller and faster to render, the leafs are not rounded to whole pixels.
+    void SvgSymbols(SVG::Writer &writer, const std::vector<Branch> &branches, int width, int height,
+                    const SVG::Metadata &metadata) const;
+
+    // Parts of the documents, for writers of their own (see ExportSvg).
+    // Shapes named for the branch: leafs, line and its groups.
+    [[nodiscard]] auto SvgNames(const Branch &branch) const -> unsigned;
+    // Branches [begin, end), names from "number" on. With classes the leafs are written as in SvgSymbols.
+    void SvgBranches(SVG::Writer &writer, const std::vector<Branch> &branches, std::size_t begin, std::size_t end,
+                     unsigned number, const SvgClasses *classes = nullptr) const;
+    // <defs> of SvgSymbols, returns its colour classes.
+    auto SvgDefs(SVG::Writer &writer, const std::vector<Branch> &branches) const -> SvgClasses;
+
+    // Tab-separated dump of the generated shapes.
+    auto Txt(const std::vector<Branch> &branches, int width, int height) const -> std::string;
+
+    // Custom images similar to leaf buttons.
+    static auto GetPoints(unsigned shape, Point pos, unsigned lenght, unsigned angle) -> std::vector<Point>;
+};
+
+/*
+ * Drawing described in a text file, used by the headless tools.
+ *
+ *      # comment
+ *      size 900 500                width and height
+ *      lineWidth 2                 branch thickness
+ *      spline 0                    1 : leafs as splines
+ *      leafPen #006600             leaf border color
+ *      leafBrush #32C832           leaf fill color
+ *      branch #823C00              branch color
+ *      random #005000 #00C800      random leaf fill color between two colors
+ *      seed 7                      seed of the next paths, default 0
+ *      simplify 1                  tolerance in pixels of the next paths, default 0 (see StrokeSimplifier)
+ *      path 2 60 50 10             shapeNumber shapeAngle shapeLenght limitLength [seed]
+ *      100,100 110,105 120,112     points of the last path, in one or more lines
+ */
+struct Drawing {
+    int width = 900;
+    int height = 500;
+    Generator generator;
+    std::vector<Path> paths;
+    unsigned seed = 0;
+
+    Drawing();
+};
+
+auto ReadDrawing(const std::string &filename, Drawing &drawing) -> bool;
+
+// Counter-based generator (SplitMix64): the same value for the same seed and index, in any order or thread.
+auto Random(std::uint64_t seed, std::uint64_t index) -> std::uint64_t;
+
+auto angularCoordinate(unsigned lenght, unsigned angle) -> Point;
+auto angularCoordinate(Point p, unsigned lenght, unsigned angle) -> Point;
+
+} // namespace Tree
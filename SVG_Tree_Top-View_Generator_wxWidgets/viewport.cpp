@@ -0,0 +1,115 @@
+#include "viewport.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Tree {
+
+// Scroll of one axis: centered if the canvas fits, else inside it.
+static auto ClampScroll(int scroll, int canvas, int view) -> int
+{
+    if (canvas <= view) {
+        return -(view - canvas) / 2;
+    }
+
+    return std::clamp(scroll, 0, canvas - view);
+}
+
+void Viewport::Clamp()
+{
+    scrollX = ClampScroll(scrollX, static_cast<int>(std::ceil(canvasWidth * zoom)), viewWidth);
+    scrollY = ClampScroll(scrollY, static_cast<int>(std::ceil(canvasHeight * zoom)), viewHeight);
+}
+
+void Viewport::SetCanvas(int width, int height)
+{
+    canvasWidth = width;
+    canvasHeight = height;
+    Clamp();
+}
+
+void Viewport::SetView(int width, int height)
+{
+    viewWidth = width;
+    viewHeight = height;
+    Clamp();
+}
+
+void Viewport::ZoomAt(double factor, int x, int y)
+{
+    auto logicalX = (x + scrollX) / zoom;
+    auto logicalY = (y + scrollY) / zoom;
+    zoom = std::clamp(zoom * factor, MinZoom, MaxZoom);
+    scrollX = static_cast<int>(std::lround(logicalX * zoom)) - x;
+    scrollY = static_cast<int>(std::lround(logicalY * zoom)) - y;
+    Clamp();
+}
+
+void Viewport::Pan(int dx, int dy)
+{
+    scrollX += dx;
+    scrollY += dy;
+    Clamp();
+}
+
+void Viewport::Fit()
+{
+    zoom = 1;
+    if (canvasWidth > 0 && canvasHeight > 0) {
+        zoom = std::clamp(std::min({1.0, static_cast<double>(viewWidth) / canvasWidth,
+                                    static_cast<double>(viewHeight) / canvasHeight}), MinZoom, MaxZoom);
+    }
+    scrollX = 0;
+    scrollY = 0;
+    Clamp();
+}
+
+auto Viewport::ToLogical(int x, int y) const -> Point
+{
+    return {static_cast<int>(std::floor((x + scrollX) / zoom)), static_cast<int>(std::floor((y + scrollY) / zoom))};
+}
+
+auto Viewport::ToScreen(const Box &box) const -> Box
+{
+    if (box.empty()) {
+        return box;
+    }
+
+    return {Point(static_cast<int>(std::floor(box.min.x * zoom)) - scrollX,
+                  static_cast<int>(std::floor(box.min.y * zoom)) - scrollY),
+            Point(static_cast<int>(std::ceil(box.max.x * zoom)) - scrollX,
+                  static_cast<int>(std::ceil(box.max.y * zoom)) - scrollY)};
+}
+
+auto Viewport::Visible() const -> Box
+{
+    auto max = ToLogical(viewWidth, viewHeight);
+
+    return {ToLogical(0, 0), Point(max.x + 1, max.y + 1)};
+}
+
+auto Viewport::Tiles() const -> Box
+{
+    auto columns = static_cast<int>(std::ceil(std::ceil(canvasWidth * zoom) / TileSize));
+    auto rows = static_cast<int>(std::ceil(std::ceil(canvasHeight * zoom) / TileSize));
+    Point first(std::max(scrollX, 0) / TileSize, std::max(scrollY, 0) / TileSize);
+    Point last(std::min(columns, (scrollX + viewWidth + TileSize - 1) / TileSize) - 1,
+               std::min(rows, (scrollY + viewHeight + TileSize - 1) / TileSize) - 1);
+
+    return {first, last};
+}
+
+auto Viewport::TileArea(int column, int row) const -> Box
+{
+    return {Point(static_cast<int>(std::floor(column * TileSize / zoom)) - 1,
+                  static_cast<int>(std::floor(row * TileSize / zoom)) - 1),
+            Point(static_cast<int>(std::ceil((column + 1) * TileSize / zoom)) + 1,
+                  static_cast<int>(std::ceil((row + 1) * TileSize / zoom)) + 1)};
+}
+
+auto Viewport::TileScreen(int column, int row) const -> Point
+{
+    return {column * TileSize - scrollX, row * TileSize - scrollY};
+}
+
+} // namespace Tree
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "tree.h"
+
+/*
+ * Zoom and pan of the canvas on screen.
+ *
+ * The drawing keeps logical coordinates, the canvas may be larger than the view. A logical point is shown at
+ * point * zoom - scroll, the scroll being in whole pixels of the zoomed canvas so that tiles of TileSize pixels
+ * cut it without seams. A canvas smaller than the view is centered in it.
+ */
+namespace Tree {
+
+class Viewport {
+public:
+    static constexpr double MinZoom = 1.0 / 64;
+    static constexpr double MaxZoom = 16;
+    static constexpr int TileSize = 256;
+
+    void SetCanvas(int width, int height);
+    void SetView(int width, int height);
+
+    [[nodiscard]] auto Zoom() const -> double { return zoom; }
+    [[nodiscard]] auto ScrollX() const -> int { return scrollX; }
+    [[nodiscard]] auto ScrollY() const -> int { return scrollY; }
+
+    // Keeps the logical point under the screen point where it is.
+    void ZoomAt(double factor, int x, int y);
+    void Pan(int dx, int dy);
+    // Whole canvas in the view, at most at its real size.
+    void Fit();
+
+    [[nodiscard]] auto ToLogical(int x, int y) const -> Point;
+    // Screen pixels covering the logical box.
+    [[nodiscard]] auto ToScreen(const Box &box) const -> Box;
+    // Logical area of the view.
+    [[nodiscard]] auto Visible() const -> Box;
+
+    // Indices of the tiles of the canvas in the view, as a box of tile coordinates. Empty if there are none.
+    [[nodiscard]] auto Tiles() const -> Box;
+    // Logical area of a tile, a little larger to cover its pixels.
+    [[nodiscard]] auto TileArea(int column, int row) const -> Box;
+    // Screen position of the top left corner of a tile.
+    [[nodiscard]] auto TileScreen(int column, int row) const -> Point;
+
+private:
+    int canvasWidth = 0, canvasHeight = 0;
+    int viewWidth = 0, viewHeight = 0;
+    double zoom = 1;
+    int scrollX = 0, scrollY = 0;
+
+    void Clamp();
+};
+
+} // namespace Tree